@@ -26,18 +26,18 @@ inline Breakpoints jsiBreakpointsToVecPairs(jsi::Runtime& rt, jsi::Value&& break
     return sortedVecPairs;
 }
 
-// C++ function to select current breakpoint based on screen width
-inline std::string getBreakpointFromScreenWidth(int screenWidth, const Breakpoints& sortedVecPairs) {
+// C++ function to select current breakpoint index based on screen width
+inline size_t getBreakpointIndexFromScreenWidth(int screenWidth, const Breakpoints& sortedVecPairs) {
     auto it = std::upper_bound(sortedVecPairs.cbegin(), sortedVecPairs.cend(), screenWidth, [](int width, const auto& pair) {
         return width < pair.second;
     });
     
     // return breakpoint with 0 as lowest
     if (it == sortedVecPairs.begin()) {
-        return sortedVecPairs.front().first;
+        return 0;
     }
     
-    return (--it)->first;
+    return std::distance(sortedVecPairs.cbegin(), it) - 1;
 }
 
 }
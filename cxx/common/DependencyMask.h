@@ -0,0 +1,93 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "NativePlatform.h"
+
+namespace margelo::nitro::unistyles::helpers {
+
+// compact set of UnistyleDependency, every dependency is represented by a single bit
+// matching is a single AND instead of hashing
+struct DependencyMask {
+    static constexpr size_t capacity = 32;
+
+    constexpr DependencyMask() = default;
+    constexpr explicit DependencyMask(uint32_t bits): bits{bits} {}
+    constexpr explicit DependencyMask(UnistyleDependency dependency): bits{bitFor(dependency)} {}
+
+    explicit DependencyMask(const std::vector<UnistyleDependency>& dependencies) {
+        for (const auto& dependency : dependencies) {
+            this->add(dependency);
+        }
+    }
+
+    // dependency must be lower than capacity, parsed ones are validated by Parser::parseDependencies
+    static constexpr uint32_t bitFor(UnistyleDependency dependency) {
+        return 1u << static_cast<uint32_t>(dependency);
+    }
+
+    inline constexpr void add(UnistyleDependency dependency) {
+        this->bits |= bitFor(dependency);
+    }
+
+    inline constexpr bool contains(UnistyleDependency dependency) const {
+        return (this->bits & bitFor(dependency)) != 0;
+    }
+
+    inline constexpr bool intersects(DependencyMask other) const {
+        return (this->bits & other.bits) != 0;
+    }
+
+    inline constexpr bool empty() const {
+        return this->bits == 0;
+    }
+
+    inline constexpr size_t size() const {
+        return std::popcount(this->bits);
+    }
+
+    template<typename F>
+    inline constexpr void forEach(F&& callback) const {
+        auto remaining = this->bits;
+
+        while (remaining != 0) {
+            auto index = std::countr_zero(remaining);
+
+            callback(static_cast<UnistyleDependency>(index));
+
+            remaining &= remaining - 1;
+        }
+    }
+
+    inline std::vector<UnistyleDependency> toVector() const {
+        std::vector<UnistyleDependency> dependencies{};
+
+        dependencies.reserve(this->size());
+
+        this->forEach([&dependencies](UnistyleDependency dependency){
+            dependencies.push_back(dependency);
+        });
+
+        return dependencies;
+    }
+
+    inline constexpr DependencyMask operator|(DependencyMask other) const {
+        return DependencyMask(this->bits | other.bits);
+    }
+
+    inline constexpr DependencyMask& operator|=(DependencyMask other) {
+        this->bits |= other.bits;
+
+        return *this;
+    }
+
+    inline constexpr bool operator==(const DependencyMask& other) const = default;
+
+    uint32_t bits = 0;
+};
+
+static_assert(static_cast<size_t>(UnistyleDependency::RTL) < DependencyMask::capacity, "Unistyles: UnistyleDependency doesn't fit into DependencyMask.");
+
+}
@@ -4,6 +4,7 @@
 #include <jsi/JSIDynamic.h>
 #include <folly/dynamic.h>
 #include "NativePlatform.h"
+#include "DependencyMask.h"
 #include <unordered_set>
 
 using namespace facebook;
@@ -219,12 +220,13 @@ inline jsi::Array functionArgumentsToArray(jsi::Runtime& rt, const jsi::Value* a
     return arr;
 }
 
-inline static jsi::Array dependenciesToJSIArray(jsi::Runtime& rt, const std::vector<UnistyleDependency>& vec) {
-    jsi::Array result(rt, vec.size());
+inline static jsi::Array dependenciesToJSIArray(jsi::Runtime& rt, DependencyMask dependencies) {
+    jsi::Array result(rt, dependencies.size());
+    size_t i = 0;
 
-    for (size_t i = 0; i < vec.size(); i++) {
-        result.setValueAtIndex(rt, i, jsi::Value(static_cast<int>(vec[i])));
-    }
+    dependencies.forEach([&rt, &result, &i](UnistyleDependency dependency){
+        result.setValueAtIndex(rt, i++, jsi::Value(static_cast<int>(dependency)));
+    });
 
     return result;
 }
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace margelo::nitro::unistyles::helpers {
+
+// number of blocks allocated at once, when pool runs out of free blocks
+constexpr size_t POOL_SLAB_SIZE = 256;
+// number of free blocks kept by every thread, they're taken and released without locking
+constexpr size_t POOL_THREAD_CACHE_SIZE = 64;
+
+// fixed size blocks carved from slabs, released block is reused by the next allocation
+// slabs are never returned to the system, so pool grows only to the peak of alive objects
+// every thread has its own cache of free blocks, shared free list is locked only to refill or trim it
+template <size_t BlockSize, size_t BlockAlignment>
+struct SlabPool {
+    static SlabPool& get() {
+        // leaked on purpose, shared pointers owned by other singletons can be released after static destructors
+        static auto* pool = new SlabPool();
+
+        return *pool;
+    }
+
+    inline void* allocate() {
+        auto& cache = getThreadCache();
+
+        if (cache.freeBlocks == nullptr) {
+            this->refillThreadCache(cache);
+        }
+
+        auto block = cache.freeBlocks;
+
+        cache.freeBlocks = block->next;
+        cache.size--;
+
+        return block;
+    }
+
+    inline void deallocate(void* ptr) noexcept {
+        auto& cache = getThreadCache();
+        auto block = static_cast<Block*>(ptr);
+
+        block->next = cache.freeBlocks;
+        cache.freeBlocks = block;
+        cache.size++;
+
+        // block can be released by other thread than the one that allocated it
+        // so cache of the releasing thread is trimmed, otherwise it would grow forever
+        if (cache.size > 2 * POOL_THREAD_CACHE_SIZE) {
+            this->trimThreadCache(cache, POOL_THREAD_CACHE_SIZE);
+        }
+    }
+
+private:
+    union Block {
+        Block* next;
+        alignas(BlockAlignment) std::byte storage[BlockSize];
+    };
+
+    struct ThreadCache {
+        Block* freeBlocks = nullptr;
+        size_t size = 0;
+
+        ~ThreadCache() {
+            // pool is never destroyed, so blocks of finished thread can be reused by others
+            SlabPool::get().trimThreadCache(*this, this->size);
+        }
+    };
+
+    static inline ThreadCache& getThreadCache() {
+        static thread_local ThreadCache cache;
+
+        return cache;
+    }
+
+    inline void refillThreadCache(ThreadCache& cache) {
+        std::lock_guard<std::mutex> lock(this->_mutex);
+
+        if (this->_freeBlocks == nullptr) {
+            this->addSlab();
+        }
+
+        while (this->_freeBlocks != nullptr && cache.size < POOL_THREAD_CACHE_SIZE) {
+            auto block = this->_freeBlocks;
+
+            this->_freeBlocks = block->next;
+            block->next = cache.freeBlocks;
+            cache.freeBlocks = block;
+            cache.size++;
+        }
+    }
+
+    inline void trimThreadCache(ThreadCache& cache, size_t count) {
+        std::lock_guard<std::mutex> lock(this->_mutex);
+
+        while (cache.freeBlocks != nullptr && count > 0) {
+            auto block = cache.freeBlocks;
+
+            cache.freeBlocks = block->next;
+            cache.size--;
+            count--;
+            block->next = this->_freeBlocks;
+            this->_freeBlocks = block;
+        }
+    }
+
+    inline void addSlab() {
+        auto& slab = this->_slabs.emplace_back(std::make_unique<Block[]>(POOL_SLAB_SIZE));
+
+        for (size_t i = 0; i < POOL_SLAB_SIZE; i++) {
+            slab[i].next = this->_freeBlocks;
+            this->_freeBlocks = &slab[i];
+        }
+    }
+
+    std::mutex _mutex;
+    Block* _freeBlocks = nullptr;
+    std::vector<std::unique_ptr<Block[]>> _slabs{};
+};
+
+// used with std::allocate_shared, so object and its control block share single pooled block
+template <typename T>
+struct PoolAllocator {
+    using value_type = T;
+
+    PoolAllocator() noexcept = default;
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+    inline T* allocate(size_t n) {
+        if (n != 1) {
+            return std::allocator<T>().allocate(n);
+        }
+
+        return static_cast<T*>(SlabPool<sizeof(T), alignof(T)>::get().allocate());
+    }
+
+    inline void deallocate(T* ptr, size_t n) noexcept {
+        if (n != 1) {
+            std::allocator<T>().deallocate(ptr, n);
+
+            return;
+        }
+
+        SlabPool<sizeof(T), alignof(T)>::get().deallocate(ptr);
+    }
+
+    template <typename U>
+    inline bool operator==(const PoolAllocator<U>&) const noexcept {
+        return true;
+    }
+};
+
+template <typename T, typename... Args>
+inline std::shared_ptr<T> makePooled(Args&&... args) {
+    return std::allocate_shared<T>(PoolAllocator<T>{}, std::forward<Args>(args)...);
+}
+
+}
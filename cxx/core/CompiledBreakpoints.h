@@ -0,0 +1,98 @@
+#pragma once
+
+#include <jsi/jsi.h>
+#include <optional>
+#include <vector>
+#include "Breakpoints.h"
+#include "Helpers.h"
+#include "MediaQueries.h"
+
+namespace margelo::nitro::unistyles::core {
+
+using namespace facebook;
+
+struct CompiledMQ {
+    UnistylesMQ mq;
+    jsi::Value value;
+};
+
+// breakpoint object eg. { xs: 1, md: 2, ':w[500]': 3 } resolved into C++ lookup tables
+// it's attached to the object as NativeState, so JS object is traversed only once
+struct CompiledBreakpoints: public jsi::NativeState {
+    CompiledBreakpoints(size_t breakpointsGeneration): breakpointsGeneration{breakpointsGeneration} {}
+
+    // breakpoints registered with StyleSheet.configure this object was compiled against
+    size_t breakpointsGeneration;
+    // valid mqs in property order, first match wins
+    std::vector<CompiledMQ> mqs{};
+    std::optional<jsi::Value> landscape = std::nullopt;
+    std::optional<jsi::Value> portrait = std::nullopt;
+    // values indexed by sorted breakpoint index
+    std::vector<std::optional<jsi::Value>> breakpointValues{};
+    // for every breakpoint index, index of the closest defined breakpoint at or below it
+    std::vector<std::optional<size_t>> resolvedBreakpoints{};
+
+    inline bool hasOrientation() const {
+        return this->landscape.has_value() || this->portrait.has_value();
+    }
+
+    inline std::optional<jsi::Value>& getOrientationValue(bool isLandscape) {
+        return isLandscape
+            ? this->landscape
+            : this->portrait;
+    }
+
+    inline jsi::Value getBreakpointValue(jsi::Runtime& rt, size_t breakpointIndex) {
+        if (breakpointIndex >= this->resolvedBreakpoints.size() || !this->resolvedBreakpoints[breakpointIndex].has_value()) {
+            return jsi::Value::undefined();
+        }
+
+        return jsi::Value(rt, this->breakpointValues[this->resolvedBreakpoints[breakpointIndex].value()].value());
+    }
+
+    static std::shared_ptr<CompiledBreakpoints> compile(jsi::Runtime& rt, jsi::Object& obj, const helpers::Breakpoints& sortedBreakpoints, size_t breakpointsGeneration) {
+        auto compiled = std::make_shared<CompiledBreakpoints>(breakpointsGeneration);
+
+        compiled->breakpointValues.resize(sortedBreakpoints.size());
+
+        helpers::enumerateJSIObject(rt, obj, [&](const std::string& propertyName, jsi::Value& propertyValue){
+            auto mq = UnistylesMQ{propertyName};
+
+            if (mq.isMQ()) {
+                compiled->mqs.emplace_back(CompiledMQ{mq, jsi::Value(rt, propertyValue)});
+            }
+
+            if (propertyName == "landscape") {
+                compiled->landscape = jsi::Value(rt, propertyValue);
+            }
+
+            if (propertyName == "portrait") {
+                compiled->portrait = jsi::Value(rt, propertyValue);
+            }
+
+            for (size_t i = 0; i < sortedBreakpoints.size(); i++) {
+                if (sortedBreakpoints[i].first == propertyName) {
+                    compiled->breakpointValues[i] = jsi::Value(rt, propertyValue);
+
+                    break;
+                }
+            }
+        });
+
+        std::optional<size_t> closestBreakpoint = std::nullopt;
+
+        compiled->resolvedBreakpoints.reserve(sortedBreakpoints.size());
+
+        for (size_t i = 0; i < compiled->breakpointValues.size(); i++) {
+            if (compiled->breakpointValues[i].has_value()) {
+                closestBreakpoint = i;
+            }
+
+            compiled->resolvedBreakpoints.emplace_back(closestBreakpoint);
+        }
+
+        return compiled;
+    }
+};
+
+}
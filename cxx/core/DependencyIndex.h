@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "NativePlatform.h"
+#include "DependencyMask.h"
+
+namespace facebook::react {
+class ShadowNodeFamily;
+}
+
+namespace margelo::nitro::unistyles::core {
+
+struct Unistyle;
+
+using namespace facebook::react;
+
+using FamiliesSet = std::unordered_set<const ShadowNodeFamily*>;
+
+// reverse lookup: dependency -> families that have at least one unistyle depending on it
+// kept up to date incrementally, so platform events visit only affected families
+struct DependencyIndex {
+    inline void linkFamily(const ShadowNodeFamily* family, const Unistyle* unistyle, helpers::DependencyMask dependencies) {
+        this->_unistyleFamilies[unistyle].insert(family);
+
+        dependencies.forEach([this, family](UnistyleDependency dependency){
+            this->familiesFor(dependency).insert(family);
+        });
+    }
+
+    // families are always unlinked as a whole, so we can remove them from every dependency
+    inline void unlinkFamily(const ShadowNodeFamily* family, const std::vector<const Unistyle*>& unistyles) {
+        for (auto& families : this->_families) {
+            families.erase(family);
+        }
+
+        for (const auto* unistyle : unistyles) {
+            auto it = this->_unistyleFamilies.find(unistyle);
+
+            if (it == this->_unistyleFamilies.end()) {
+                continue;
+            }
+
+            it->second.erase(family);
+
+            if (it->second.empty()) {
+                this->_unistyleFamilies.erase(it);
+            }
+        }
+    }
+
+    // called when already linked unistyle discovered new dependency (eg. breakpoints)
+    inline void onDependencyAdded(const Unistyle* unistyle, UnistyleDependency dependency) {
+        auto it = this->_unistyleFamilies.find(unistyle);
+
+        if (it == this->_unistyleFamilies.end()) {
+            return;
+        }
+
+        this->familiesFor(dependency).insert(it->second.begin(), it->second.end());
+    }
+
+    inline FamiliesSet getFamilies(helpers::DependencyMask dependencies) {
+        FamiliesSet families;
+
+        dependencies.forEach([this, &families](UnistyleDependency dependency){
+            auto& dependentFamilies = this->familiesFor(dependency);
+
+            families.insert(dependentFamilies.begin(), dependentFamilies.end());
+        });
+
+        return families;
+    }
+
+private:
+    inline FamiliesSet& familiesFor(UnistyleDependency dependency) {
+        return this->_families[static_cast<size_t>(dependency)];
+    }
+
+    std::array<FamiliesSet, helpers::DependencyMask::capacity> _families{};
+    std::unordered_map<const Unistyle*, FamiliesSet> _unistyleFamilies{};
+};
+
+}
@@ -1,23 +1,66 @@
 #include "HashGenerator.h"
-#include <sstream>
-#include <iomanip>
-#include <functional>
 
 namespace margelo::nitro::unistyles::helpers {
 
-std::atomic<unsigned int> HashGenerator::count(0);
+// 32-bit FNV-1a, style key and StyleSheet tag are hashed without building intermediate string
+// the same style in the same StyleSheet keeps its unid, so JS objects survive Fast Refresh
+Unid HashGenerator::generateUnid(std::string_view styleKey, int tag) {
+    uint32_t hash = 2166136261u;
 
-std::string HashGenerator::generateHash(const std::string& input) {
-    std::hash<std::string> stringHasher;
-    uint64_t inputHash = stringHasher(input);
+    auto hashByte = [&hash](uint8_t byte){
+        hash ^= byte;
+        hash *= 16777619u;
+    };
 
-    unsigned int counterValue = count.fetch_add(1, std::memory_order_relaxed);
-    uint64_t combinedHash = inputHash ^ (static_cast<uint64_t>(counterValue) << 32);
+    for (auto character : styleKey) {
+        hashByte(static_cast<uint8_t>(character));
+    }
 
-    std::stringstream ss;
-    ss << std::hex << std::setfill('0') << std::setw(8) << (combinedHash & 0xFFFFFFFF);
+    auto unsignedTag = static_cast<uint32_t>(tag);
 
-    return "unistyles_" + ss.str();
+    for (size_t i = 0; i < sizeof(unsignedTag); i++) {
+        hashByte(static_cast<uint8_t>(unsignedTag >> (i * 8)));
+    }
+
+    return hash;
+}
+
+std::string HashGenerator::formatUnid(Unid unid) {
+    static constexpr char hexDigits[] = "0123456789abcdef";
+
+    std::string key(UNID_PREFIX.size() + UNID_HEX_LENGTH, '0');
+
+    key.replace(0, UNID_PREFIX.size(), UNID_PREFIX);
+
+    for (size_t i = 0; i < UNID_HEX_LENGTH; i++) {
+        key[key.size() - 1 - i] = hexDigits[(unid >> (i * 4)) & 0xF];
+    }
+
+    return key;
+}
+
+std::optional<Unid> HashGenerator::parseUnid(std::string_view key) {
+    if (key.size() != UNID_PREFIX.size() + UNID_HEX_LENGTH || !key.starts_with(UNID_PREFIX)) {
+        return std::nullopt;
+    }
+
+    Unid unid = 0;
+
+    for (auto character : key.substr(UNID_PREFIX.size())) {
+        uint32_t digit;
+
+        if (character >= '0' && character <= '9') {
+            digit = character - '0';
+        } else if (character >= 'a' && character <= 'f') {
+            digit = character - 'a' + 10;
+        } else {
+            return std::nullopt;
+        }
+
+        unid = (unid << 4) | digit;
+    }
+
+    return unid;
 }
 
 }
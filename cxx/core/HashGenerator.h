@@ -1,13 +1,23 @@
 #pragma once
 
+#include <cstdint>
+#include <optional>
 #include <string>
-#include <atomic>
+#include <string_view>
 
 namespace margelo::nitro::unistyles::helpers {
 
+// unistyle id, it's formatted to string only when exposed to JS
+using Unid = uint32_t;
+
+// JS keys are prefix followed by 8 lowercase hex digits
+static constexpr std::string_view UNID_PREFIX = "unistyles_";
+static constexpr size_t UNID_HEX_LENGTH = 8;
+
 struct HashGenerator {
-    static std::atomic<unsigned int> count;
-    static std::string generateHash(const std::string& input);
+    static Unid generateUnid(std::string_view styleKey, int tag = 0);
+    static std::string formatUnid(Unid unid);
+    static std::optional<Unid> parseUnid(std::string_view key);
 };
 
 }
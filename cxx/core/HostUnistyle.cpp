@@ -32,6 +32,9 @@ jsi::Value HostUnistyle::get(jsi::Runtime& rt, const jsi::PropNameID& propNameId
         return this->createAddVariantsProxyFunction(rt);
     }
 
+    // evicted StyleSheet has no unistyles, so without this check user would silently get undefined
+    helpers::assertThat(rt, !this->_stylesheet->wasReleased(), "Unistyles: You're trying to read '" + propertyName + "' from StyleSheet that was released with StyleSheet.release. Create it again instead.");
+
     if (!this->_stylesheet->unistyles.contains(propertyName)) {
         return jsi::Value::undefined();
     }
@@ -88,8 +91,7 @@ jsi::Function HostUnistyle::createAddVariantsProxyFunction(jsi::Runtime& rt) {
         parser::Parser parser = parser::Parser(this->_unistylesRuntime);
 
         auto stylesheetCopy = std::make_shared<StyleSheet>(
-            this->_stylesheet->tag,
-            this->_stylesheet->type,
+            this->_stylesheet->origin != nullptr ? this->_stylesheet->origin : this->_stylesheet,
             jsi::Value(rt, this->_stylesheet->rawValue).asObject(rt)
         );
         
@@ -10,7 +10,13 @@ using Variants = std::vector<std::pair<std::string, std::string>>;
 
 struct JSI_EXPORT HostUnistyle : public jsi::HostObject {
     HostUnistyle(std::shared_ptr<StyleSheet> stylesheet, std::shared_ptr<HybridUnistylesRuntime> unistylesRuntime, Variants& variants)
-        : _stylesheet(stylesheet), _unistylesRuntime{unistylesRuntime}, _variants{std::move(variants)} {};
+        : _stylesheet(stylesheet), _unistylesRuntime{unistylesRuntime}, _variants{std::move(variants)} {
+        this->_stylesheet->addReference();
+    };
+
+    ~HostUnistyle() override {
+        this->_stylesheet->removeReference();
+    }
 
     std::vector<jsi::PropNameID> getPropertyNames(jsi::Runtime& rt);
     jsi::Value get(jsi::Runtime& rt, const jsi::PropNameID& propNameId);
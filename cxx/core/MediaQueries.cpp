@@ -1,59 +1,154 @@
 #include "MediaQueries.h"
+#include <limits>
+#include <mutex>
+#include <unordered_map>
 
 using namespace margelo::nitro::unistyles;
 
+namespace {
+
+// every distinct mq is parsed once per process, nullopt means that key is not a valid mq
+std::mutex compiledMQsMutex;
+std::unordered_map<std::string, std::optional<core::ParsedMQ>> compiledMQs{};
+
+inline bool isDigit(char character) {
+    return character >= '0' && character <= '9';
+}
+
+inline bool isWhitespace(char character) {
+    return character == ' ' || character == '\t' || character == '\n' || character == '\r' || character == '\f' || character == '\v';
+}
+
+// consumes \d+ and returns its value
+std::optional<double> parseNumber(std::string_view maybeMQ, size_t& position) {
+    auto start = position;
+    double value = 0;
+
+    while (position < maybeMQ.size() && isDigit(maybeMQ[position])) {
+        value = value * 10 + (maybeMQ[position] - '0');
+        position++;
+    }
+
+    if (position == start) {
+        return std::nullopt;
+    }
+
+    return value;
+}
+
+}
+
 bool core::UnistylesMQ::isMQ() {
     return this->isValid;
 }
 
-bool core::UnistylesMQ::checkIsMQ(const std::string& maybeMQ) {
-    std::regex pattern(R"(:([hw])\[(\d+)(?:,\s*(\d+|Infinity))?\])");
+std::optional<core::ParsedMQ> core::UnistylesMQ::getCompiledMQ(const std::string& maybeMQ) {
+    // every mq starts with ':', skip cache for regular breakpoint names
+    if (maybeMQ.find(':') == std::string::npos) {
+        return std::nullopt;
+    }
+
+    std::lock_guard<std::mutex> lock(compiledMQsMutex);
+
+    auto it = compiledMQs.find(maybeMQ);
+
+    if (it != compiledMQs.end()) {
+        return it->second;
+    }
 
-    return std::regex_search(maybeMQ, pattern);
+    auto parsedMQ = parseMQ(maybeMQ);
+
+    if (parsedMQ.has_value() && !checkIsValidMQ(parsedMQ.value())) {
+        parsedMQ = std::nullopt;
+    }
+
+    compiledMQs.emplace(maybeMQ, parsedMQ);
+
+    return parsedMQ;
 }
 
-bool core::UnistylesMQ::checkIsValidMQ() {
-    if (parsedMQ->width && parsedMQ->height) {
-        return parsedMQ->width->from <= parsedMQ->width->to && parsedMQ->height->from <= parsedMQ->height->to;
+bool core::UnistylesMQ::checkIsValidMQ(const ParsedMQ& parsedMQ) {
+    if (parsedMQ.width && parsedMQ.height) {
+        return parsedMQ.width->from <= parsedMQ.width->to && parsedMQ.height->from <= parsedMQ.height->to;
     }
 
-    if (parsedMQ->width) {
-        return parsedMQ->width->from <= parsedMQ->width->to;
+    if (parsedMQ.width) {
+        return parsedMQ.width->from <= parsedMQ.width->to;
     }
 
-    if (parsedMQ->height) {
-        return parsedMQ->height->from <= parsedMQ->height->to;
+    if (parsedMQ.height) {
+        return parsedMQ.height->from <= parsedMQ.height->to;
     }
-    
+
     return false;
 }
 
-void core::UnistylesMQ::parseMQ(const std::string& maybeMQ) {
-    const std::regex UNISTYLES_WIDTH_REGEX(R"(:(w)\[(\d+)(?:,\s*(\d+|Infinity))?\])");
-    const std::regex UNISTYLES_HEIGHT_REGEX(R"(:(h)\[(\d+)(?:,\s*(\d+|Infinity))?\])");
-
+// hand written equivalent of :(w|h)\[(\d+)(?:,\s*(\d+|Infinity))?\]
+std::optional<core::ParsedMQ> core::UnistylesMQ::parseMQ(std::string_view maybeMQ) {
     ParsedMQ result;
-    std::smatch match;
 
-    if (std::regex_search(maybeMQ, match, UNISTYLES_WIDTH_REGEX)) {
-        double from = std::stod(match[2]);
-        double to = match[3].matched
-        ? (match[3] == "Infinity" ? std::numeric_limits<double>::infinity(): std::stod(match[3]))
-        : from;
-        
-        result.width = ParsedMQDimension{from, to};
+    result.width = parseDimension(maybeMQ, 'w');
+    result.height = parseDimension(maybeMQ, 'h');
+
+    if (!result.width.has_value() && !result.height.has_value()) {
+        return std::nullopt;
     }
 
-    if (std::regex_search(maybeMQ, match, UNISTYLES_HEIGHT_REGEX)) {
-        double from = std::stod(match[2]);
-        double to = match[3].matched
-        ? (match[3] == "Infinity" ? std::numeric_limits<double>::infinity() : std::stod(match[3]))
-        : from;
+    return result;
+}
+
+// first match wins, same as regex_search
+std::optional<core::ParsedMQDimension> core::UnistylesMQ::parseDimension(std::string_view maybeMQ, char dimension) {
+    const char prefix[] = {':', dimension, '['};
+    auto position = maybeMQ.find(std::string_view(prefix, 3));
+
+    while (position != std::string_view::npos) {
+        auto parsedDimension = parseDimensionAt(maybeMQ, position + 3);
 
-        result.height = ParsedMQDimension{from, to};
+        if (parsedDimension.has_value()) {
+            return parsedDimension;
+        }
+
+        position = maybeMQ.find(std::string_view(prefix, 3), position + 1);
     }
-    
-    this->parsedMQ = result;
+
+    return std::nullopt;
+}
+
+// parses "100]" or "100, 200]" or "100,Infinity]"
+std::optional<core::ParsedMQDimension> core::UnistylesMQ::parseDimensionAt(std::string_view maybeMQ, size_t position) {
+    auto from = parseNumber(maybeMQ, position);
+
+    if (!from.has_value() || position >= maybeMQ.size()) {
+        return std::nullopt;
+    }
+
+    if (maybeMQ[position] == ']') {
+        return ParsedMQDimension{from.value(), from.value()};
+    }
+
+    if (maybeMQ[position] != ',') {
+        return std::nullopt;
+    }
+
+    position++;
+
+    while (position < maybeMQ.size() && isWhitespace(maybeMQ[position])) {
+        position++;
+    }
+
+    auto to = parseNumber(maybeMQ, position);
+
+    if (!to.has_value() && maybeMQ.substr(position).starts_with("Infinity")) {
+        to = std::numeric_limits<double>::infinity();
+        position += 8;
+    }
+
+    if (!to.has_value() || position >= maybeMQ.size() || maybeMQ[position] != ']') {
+        return std::nullopt;
+    }
+
+    return ParsedMQDimension{from.value(), to.value()};
 }
 
 bool core::UnistylesMQ::isWithinScreenWidth(const ParsedMQDimension& width, double screenWidth) {
@@ -68,9 +163,9 @@ bool core::UnistylesMQ::isWithinTheWidthAndHeight(const Dimensions& screenSize)
     if (!isValid) {
         return false;
     }
-    
-    auto parsedMq = parsedMQ.value();
-    
+
+    auto& parsedMq = parsedMQ.value();
+
     if (parsedMq.width && parsedMq.height) {
         return isWithinScreenWidth(*parsedMq.width, screenSize.width) && isWithinScreenHeight(*parsedMq.height, screenSize.height);
     }
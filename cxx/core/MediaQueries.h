@@ -1,7 +1,8 @@
 #pragma once
 
 #include <optional>
-#include <regex>
+#include <string>
+#include <string_view>
 #include "Dimensions.hpp"
 
 namespace margelo::nitro::unistyles::core {
@@ -18,28 +19,22 @@ struct ParsedMQ {
 
 struct UnistylesMQ {
     UnistylesMQ(const std::string& maybeMQ) {
-        if (!this->checkIsMQ(maybeMQ)) {
-            return;
-        }
-        
-        this->parseMQ(maybeMQ);
-        
-        if (!this->checkIsValidMQ()) {
-            return;
-        }
-        
-        this->isValid = true;
+        this->parsedMQ = getCompiledMQ(maybeMQ);
+        this->isValid = this->parsedMQ.has_value();
     }
 
     bool isMQ();
     bool isWithinTheWidthAndHeight(const Dimensions& screenSize);
-    
+
 private:
     bool isValid = false;
     std::optional<ParsedMQ> parsedMQ;
-    bool checkIsValidMQ();
-    bool checkIsMQ(const std::string& maybeMQ);
-    void parseMQ(const std::string& maybeMQ);
+
+    static std::optional<ParsedMQ> getCompiledMQ(const std::string& maybeMQ);
+    static std::optional<ParsedMQ> parseMQ(std::string_view maybeMQ);
+    static std::optional<ParsedMQDimension> parseDimension(std::string_view maybeMQ, char dimension);
+    static std::optional<ParsedMQDimension> parseDimensionAt(std::string_view maybeMQ, size_t position);
+    static bool checkIsValidMQ(const ParsedMQ& parsedMQ);
     bool isWithinScreenWidth(const ParsedMQDimension& width, double screenWidth);
     bool isWithinScreenHeight(const ParsedMQDimension& height, double screenHeight);
 };
@@ -0,0 +1,69 @@
+#include "PropertyTable.h"
+#include <algorithm>
+#include "UnistylesConstants.h"
+#include "ColorProps.h"
+
+using namespace margelo::nitro::unistyles;
+
+core::PropertyTable::PropertyTable(jsi::Runtime& rt) {
+    // order must match KnownProperty
+    for (const auto& name : {
+        helpers::STYLE_DEPENDENCIES,
+        helpers::WEB_STYLE_KEY,
+        std::string("variants"),
+        std::string("compoundVariants"),
+        std::string("transform"),
+        std::string("boxShadow"),
+        std::string("filter"),
+        std::string("fontVariant"),
+        std::string("shadowOffset"),
+        std::string("textShadowOffset"),
+        std::string("includeFontPadding")
+    }) {
+        this->intern(rt, name);
+    }
+}
+
+const core::Property& core::PropertyTable::intern(jsi::Runtime& rt, const std::string& name) {
+    auto it = this->_ids.find(name);
+
+    if (it != this->_ids.end()) {
+        return *this->_properties[it->second];
+    }
+
+    auto id = static_cast<PropertyId>(this->_properties.size());
+
+    this->_properties.emplace_back(std::make_unique<Property>(rt, id, name, checkIsColor(name)));
+    this->_ids.emplace(name, id);
+
+    return *this->_properties.back();
+}
+
+const core::Property& core::PropertyTable::get(KnownProperty knownProperty) {
+    return *this->_properties[static_cast<PropertyId>(knownProperty)];
+}
+
+void core::PropertyTable::forEach(jsi::Runtime& rt, const jsi::Object& obj, std::function<void(const Property& property, jsi::Value& propertyValue)> callback) {
+    jsi::Array propertyNames = obj.getPropertyNames(rt);
+    size_t length = propertyNames.size(rt);
+
+    for (size_t i = 0; i < length; i++) {
+        auto& property = this->intern(rt, propertyNames.getValueAtIndex(rt, i).asString(rt).utf8(rt));
+        auto propertyValue = obj.getProperty(rt, property.propNameID);
+
+        callback(property, propertyValue);
+    }
+}
+
+// computed once per interned name
+bool core::PropertyTable::checkIsColor(const std::string& name) {
+    if (parser::isKnownColorProp(name)) {
+        return true;
+    }
+
+    // fallback heuristic for unknown keys
+    std::string str = name;
+    std::transform(str.begin(), str.end(), str.begin(), ::tolower);
+
+    return str.find("color") != std::string::npos;
+}
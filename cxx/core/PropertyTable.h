@@ -0,0 +1,62 @@
+#pragma once
+
+#include <jsi/jsi.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace margelo::nitro::unistyles::core {
+
+using namespace facebook;
+
+using PropertyId = uint32_t;
+
+// keys that parser needs to recognize, they are interned first so ids are stable
+enum class KnownProperty: PropertyId {
+    STYLE_DEPENDENCIES,
+    WEB_STYLE,
+    VARIANTS,
+    COMPOUND_VARIANTS,
+    TRANSFORM,
+    BOX_SHADOW,
+    FILTER,
+    FONT_VARIANT,
+    SHADOW_OFFSET,
+    TEXT_SHADOW_OFFSET,
+    INCLUDE_FONT_PADDING
+};
+
+struct Property {
+    Property(jsi::Runtime& rt, PropertyId id, const std::string& name, bool isColor)
+        : id{id}, name{name}, propNameID{jsi::PropNameID::forUtf8(rt, name)}, isColor{isColor} {}
+
+    const PropertyId id;
+    const std::string name;
+    const jsi::PropNameID propNameID;
+    const bool isColor;
+
+    inline KnownProperty known() const {
+        return static_cast<KnownProperty>(this->id);
+    }
+};
+
+// per runtime table of interned property names with cached PropNameIDs
+struct PropertyTable {
+    PropertyTable(jsi::Runtime& rt);
+    PropertyTable(const PropertyTable&) = delete;
+
+    const Property& intern(jsi::Runtime& rt, const std::string& name);
+    const Property& get(KnownProperty knownProperty);
+    void forEach(jsi::Runtime& rt, const jsi::Object& obj, std::function<void(const Property& property, jsi::Value& propertyValue)> callback);
+
+private:
+    static bool checkIsColor(const std::string& name);
+
+    // unique_ptr keeps references stable while table grows
+    std::vector<std::unique_ptr<Property>> _properties{};
+    std::unordered_map<std::string, PropertyId> _ids{};
+};
+
+}
@@ -1,9 +1,11 @@
 #pragma once
 
 #include <jsi/jsi.h>
+#include <atomic>
 #include "Unistyle.h"
 #include "Helpers.h"
 #include "UnistylesConstants.h"
+#include "DependencyMask.h"
 
 namespace margelo::nitro::unistyles::core {
 
@@ -17,6 +19,8 @@ enum class StyleSheetType {
 
 struct StyleSheet {
     StyleSheet(int tag, StyleSheetType type, jsi::Object rawValue): tag{tag}, type{type}, rawValue{std::move(rawValue)} {};
+    StyleSheet(std::shared_ptr<StyleSheet> origin, jsi::Object rawValue)
+        : tag{origin->tag}, type{origin->type}, rawValue{std::move(rawValue)}, origin{std::move(origin)} {};
     
     StyleSheet(const StyleSheet&) = delete;
     StyleSheet(StyleSheet&& other) = delete;
@@ -25,6 +29,39 @@ struct StyleSheet {
     StyleSheetType type;
     jsi::Object rawValue;
     std::unordered_map<std::string, Unistyle::Shared> unistyles{};
+
+    // sum of all unistyles dependencies, updated by unistyles
+    helpers::DependencyMask dependencies{};
+
+    // HostUnistyles, unistyle wrappers and linked shadow nodes using this StyleSheet
+    // StyleSheet without references can't be reached anymore and is evicted from the registry
+    std::atomic<size_t> references{0};
+    // StyleSheet.release was called, so it's evicted regardless of references
+    bool isReleased = false;
+    // useVariants copy is not registered, it shares references and release with its origin
+    std::shared_ptr<StyleSheet> origin{};
+
+    inline StyleSheet& registered() {
+        return this->origin != nullptr
+            ? *this->origin
+            : *this;
+    }
+
+    inline void addReference() {
+        this->registered().references.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    inline void removeReference() {
+        this->registered().references.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    inline bool wasReleased() {
+        return this->registered().isReleased;
+    }
+
+    inline bool canBeEvicted() {
+        return this->isReleased || this->references.load(std::memory_order_acquire) == 0;
+    }
 };
 
 }
@@ -0,0 +1,13 @@
+#include "Unistyle.h"
+#include "StyleSheet.h"
+
+using namespace margelo::nitro::unistyles;
+
+void core::Unistyle::propagateDependencies(helpers::DependencyMask newDependencies) {
+    // exotic unistyles don't have any StyleSheet
+    if (this->parent == nullptr) {
+        return;
+    }
+
+    this->parent->dependencies |= newDependencies;
+}
@@ -4,6 +4,10 @@
 #include <jsi/jsi.h>
 #include <folly/dynamic.h>
 #include "NativePlatform.h"
+#include "DependencyIndex.h"
+#include "DependencyMask.h"
+#include "PoolAllocator.h"
+#include "HashGenerator.h"
 
 namespace margelo::nitro::unistyles::core {
 
@@ -19,8 +23,8 @@ enum class UnistyleType {
 struct Unistyle {
     using Shared = std::shared_ptr<Unistyle>;
 
-    Unistyle(std::string hash, UnistyleType type, std::string styleKey, jsi::Object& rawObject, std::shared_ptr<StyleSheet> styleSheet)
-        : unid{hash}, styleKey{styleKey}, type{type}, rawValue{std::move(rawObject)}, parent{styleSheet} {}
+    Unistyle(helpers::Unid unid, UnistyleType type, std::string styleKey, jsi::Object& rawObject, std::shared_ptr<StyleSheet> styleSheet)
+        : unid{unid}, styleKey{std::move(styleKey)}, type{type}, rawValue{std::move(rawObject)}, parent{std::move(styleSheet)} {}
     virtual ~Unistyle() = default;
 
     Unistyle(const Unistyle&) = delete;
@@ -28,12 +32,15 @@ struct Unistyle {
 
     UnistyleType type;
     std::string styleKey;
-    std::string unid;
+    helpers::Unid unid;
     jsi::Object rawValue;
     std::optional<jsi::Object> parsedStyle;
-    std::vector<UnistyleDependency> dependencies{};
+    helpers::DependencyMask dependencies{};
     std::shared_ptr<StyleSheet> parent;
 
+    // set once unistyle is linked with any shadow node
+    std::weak_ptr<DependencyIndex> dependencyIndex{};
+
     // defines if given unattached unistyle was modified
     // and should be recomputed when mounting new node
     bool isDirty = false;
@@ -44,25 +51,37 @@ struct Unistyle {
             return;
         }
 
-        auto it = std::find(this->dependencies.begin(), this->dependencies.end(), dependency);
+        this->addDependencies(helpers::DependencyMask(dependency));
+    }
 
-        if (it == this->dependencies.end()) {
-            this->dependencies.push_back(dependency);
+    inline void addDependencies(helpers::DependencyMask newDependencies) {
+        // we can't add dependencies if unistyle is sealed
+        if (this->_isSealed) {
+            return;
         }
+
+        this->dependencies |= newDependencies;
+        this->propagateDependencies(newDependencies);
     }
 
     inline void addBreakpointDependency() {
         // this dependency can skip sealed check, as useVariants hook is called during React component render
         // also this is the only dependency that is not staticly deducted from Babel plugin
-        auto it = std::find(this->dependencies.begin(), this->dependencies.end(), UnistyleDependency::BREAKPOINTS);
+        if (this->dependencies.contains(UnistyleDependency::BREAKPOINTS)) {
+            return;
+        }
 
-        if (it == this->dependencies.end()) {
-            this->dependencies.push_back(UnistyleDependency::BREAKPOINTS);
+        this->dependencies.add(UnistyleDependency::BREAKPOINTS);
+        this->propagateDependencies(helpers::DependencyMask(UnistyleDependency::BREAKPOINTS));
+
+        // unistyle may be already linked, so we need to let index know about new dependency
+        if (auto index = this->dependencyIndex.lock()) {
+            index->onDependencyAdded(this, UnistyleDependency::BREAKPOINTS);
         }
     }
 
     inline bool dependsOn(UnistyleDependency dependency) {
-        return std::find(this->dependencies.begin(), this->dependencies.end(), dependency) != this->dependencies.end();
+        return this->dependencies.contains(dependency);
     }
 
     inline bool isSealed() {
@@ -75,6 +94,9 @@ struct Unistyle {
 
 private:
     bool _isSealed = false;
+
+    // summarize dependencies at StyleSheet level
+    void propagateDependencies(helpers::DependencyMask newDependencies);
 };
 
 struct UnistyleDynamicFunction: public Unistyle {
@@ -84,8 +106,8 @@ struct UnistyleDynamicFunction: public Unistyle {
     // unprocessedValue <- object generated after calling proxy and user's original function
     // parsedStyle <- parsed with Unistyle's parser
 
-    UnistyleDynamicFunction(std::string hash, UnistyleType type, std::string styleKey, jsi::Object& rawObject, std::shared_ptr<StyleSheet> styleSheet)
-        : Unistyle(hash, type, styleKey, rawObject, styleSheet) {}
+    UnistyleDynamicFunction(helpers::Unid unid, UnistyleType type, std::string styleKey, jsi::Object& rawObject, std::shared_ptr<StyleSheet> styleSheet)
+        : Unistyle(unid, type, std::move(styleKey), rawObject, std::move(styleSheet)) {}
 
     UnistyleDynamicFunction(const UnistyleDynamicFunction&) = delete;
     UnistyleDynamicFunction(UnistyleDynamicFunction&& other) = delete;
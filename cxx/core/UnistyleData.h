@@ -9,7 +9,7 @@ using Variants = std::vector<std::pair<std::string, std::string>>;
 
 struct UnistyleData {
     UnistyleData(Unistyle::Shared unistyle, const Variants& variants, std::vector<folly::dynamic>& arguments, std::optional<std::string> scopedTheme)
-        : unistyle{unistyle}, variants(std::move(variants)), dynamicFunctionMetadata{std::move(arguments)}, scopedTheme{scopedTheme} {}
+        : unistyle{std::move(unistyle)}, variants(std::move(variants)), dynamicFunctionMetadata{std::move(arguments)}, scopedTheme{scopedTheme} {}
 
     UnistyleData(const UnistyleData&) = delete;
     UnistyleData(UnistyleData&& other) = delete;
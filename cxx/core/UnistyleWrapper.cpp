@@ -2,4 +2,8 @@
 
 using namespace margelo::nitro::unistyles;
 
-core::UnistyleWrapper::~UnistyleWrapper() = default;
+core::UnistyleWrapper::~UnistyleWrapper() {
+    if (this->unistyle->parent != nullptr) {
+        this->unistyle->parent->removeReference();
+    }
+}
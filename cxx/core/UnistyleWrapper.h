@@ -12,7 +12,12 @@ namespace margelo::nitro::unistyles::core {
 
 struct UnistyleWrapper: public jsi::NativeState {
     explicit UnistyleWrapper(Unistyle::Shared unistyle)
-        : unistyle(std::move(unistyle)) {}
+        : unistyle(std::move(unistyle)) {
+        // exotic unistyles don't have StyleSheet
+        if (this->unistyle->parent != nullptr) {
+            this->unistyle->parent->addReference();
+        }
+    }
 
     ~UnistyleWrapper() override;
 
@@ -20,8 +25,8 @@ struct UnistyleWrapper: public jsi::NativeState {
 };
 
 inline static Unistyle::Shared unistyleFromStaticStyleSheet(jsi::Runtime& rt, jsi::Object& value) {
-    auto exoticUnistyle = std::make_shared<Unistyle>(
-        helpers::HashGenerator::generateHash(helpers::EXOTIC_STYLE_KEY),
+    auto exoticUnistyle = helpers::makePooled<Unistyle>(
+        helpers::HashGenerator::generateUnid(helpers::EXOTIC_STYLE_KEY),
         UnistyleType::Object,
         helpers::EXOTIC_STYLE_KEY,
         value,
@@ -35,7 +40,6 @@ inline static Unistyle::Shared unistyleFromStaticStyleSheet(jsi::Runtime& rt, js
 
 inline static std::vector<std::string> getUnistylesHashKeys(jsi::Runtime& rt, jsi::Object& object) {
     std::vector<std::string> matchingKeys{};
-    const std::string prefix = "unistyles_";
 
     auto propertyNames = object.getPropertyNames(rt);
     size_t length = propertyNames.length(rt);
@@ -44,7 +48,7 @@ inline static std::vector<std::string> getUnistylesHashKeys(jsi::Runtime& rt, js
         auto propertyName = propertyNames.getValueAtIndex(rt, i).getString(rt);
         std::string key = propertyName.utf8(rt);
 
-        if (key.compare(0, prefix.length(), prefix) == 0) {
+        if (key.starts_with(helpers::UNID_PREFIX)) {
             matchingKeys.push_back(key);
         }
     }
@@ -57,7 +61,12 @@ inline static std::vector<Unistyle::Shared> unistylesFromHashKeys(jsi::Runtime&
     auto& registry = UnistylesRegistry::get();
 
     for (auto& key: keys) {
-        unistyles.emplace_back(registry.getUnistyleById(rt, key));
+        auto unid = helpers::HashGenerator::parseUnid(key);
+
+        unistyles.emplace_back(unid.has_value()
+            ? registry.getUnistyleById(rt, unid.value())
+            : nullptr
+        );
     }
 
     return unistyles;
@@ -126,7 +135,7 @@ inline static std::vector<Unistyle::Shared> unistyleFromValue(jsi::Runtime& rt,
 
 inline static jsi::Value objectFromUnistyle(jsi::Runtime& rt, std::shared_ptr<HybridUnistylesRuntime> unistylesRuntime, Unistyle::Shared unistyle, Variants& variants, std::optional<jsi::Array> arguments) {
     auto wrappedUnistyle = std::make_shared<UnistyleWrapper>(unistyle);
-    auto unistyleID = jsi::PropNameID::forUtf8(rt, unistyle->unid);
+    auto unistyleID = jsi::PropNameID::forUtf8(rt, helpers::HashGenerator::formatUnid(unistyle->unid));
 
     jsi::Object obj = jsi::Object(rt);
 
@@ -154,10 +163,14 @@ inline static jsi::Value objectFromUnistyle(jsi::Runtime& rt, std::shared_ptr<Hy
         rt,
         jsi::PropNameID::forUtf8(rt, helpers::GET_STYLES.c_str()),
         0,
-        [unistyleID = unistyle->unid, unistylesRuntime, variants, parsedArguments](jsi::Runtime &rt, const jsi::Value &thisValue, const jsi::Value *args, size_t count
+        [weakUnistyle = std::weak_ptr<Unistyle>(unistyle), unistylesRuntime, variants, parsedArguments](jsi::Runtime &rt, const jsi::Value &thisValue, const jsi::Value *args, size_t count
     ) {
-        auto& registry = UnistylesRegistry::get();
-        auto unistyle = registry.getUnistyleById(rt, unistyleID);
+        auto unistyle = weakUnistyle.lock();
+
+        // style object was already collected, there is nothing to rebuild
+        if (unistyle == nullptr) {
+            return jsi::Object(rt);
+        }
 
         parser::Parser(unistylesRuntime).rebuildUnistyle(rt, unistyle, variants, parsedArguments);
 
@@ -179,7 +192,7 @@ inline static jsi::Value valueFromUnistyle(jsi::Runtime& rt, std::shared_ptr<Hyb
     }
 
     auto wrappedUnistyle = std::make_shared<UnistyleWrapper>(unistyle);
-    auto unistyleID = jsi::PropNameID::forUtf8(rt, unistyle->unid);
+    auto unistyleID = jsi::PropNameID::forUtf8(rt, helpers::HashGenerator::formatUnid(unistyle->unid));
 
     auto unistyleFn = std::dynamic_pointer_cast<UnistyleDynamicFunction>(unistyle);
     auto hostFn = jsi::Value(rt, unistyleFn->proxiedFunction.value()).asObject(rt).asFunction(rt);
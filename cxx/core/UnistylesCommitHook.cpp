@@ -0,0 +1,170 @@
+#include "UnistylesCommitHook.h"
+
+using namespace margelo::nitro::unistyles;
+using namespace facebook::react;
+
+#if REACT_NATIVE_VERSION_MINOR >= 80
+RootShadowNode::Unshared core::UnistylesCommitHook::shadowTreeWillCommit(
+    const ShadowTree& shadowTree,
+    const RootShadowNode::Shared& oldRootShadowNode,
+    const RootShadowNode::Unshared& newRootShadowNode,
+    const ShadowTree::CommitOptions& commitOptions
+) noexcept {
+    // this is Unistyles commit, props are already there
+    if (this->isUnistylesCommit(newRootShadowNode)) {
+        return newRootShadowNode;
+    }
+
+    this->flushOffscreenUpdates();
+
+    // Reanimated and other libraries commits already contain Unistyles props
+    if (commitOptions.source != ShadowTree::CommitSource::React && commitOptions.source != ShadowTree::CommitSource::ReactRevisionMerge) {
+        return newRootShadowNode;
+    }
+
+    return this->applyUnistylesProps(shadowTree, oldRootShadowNode, newRootShadowNode);
+}
+#else
+RootShadowNode::Unshared core::UnistylesCommitHook::shadowTreeWillCommit(
+    const ShadowTree& shadowTree,
+    const RootShadowNode::Shared& oldRootShadowNode,
+    const RootShadowNode::Unshared& newRootShadowNode
+) noexcept {
+    // without commit source, Reanimated and other libraries commits can't be told apart from React ones
+    // and re-applied props would override theirs, so native props keep Unistyles props on these versions
+    if (!this->isUnistylesCommit(newRootShadowNode)) {
+        this->flushOffscreenUpdates();
+    }
+
+    return newRootShadowNode;
+}
+#endif
+
+// trait is removed, otherwise it would be copied to the next commit
+bool core::UnistylesCommitHook::isUnistylesCommit(const RootShadowNode::Unshared& newRootShadowNode) {
+    auto unistylesRootNode = std::reinterpret_pointer_cast<core::UnistylesCommitShadowNode>(newRootShadowNode);
+
+    if (unistylesRootNode->hasUnistylesCommitTrait()) {
+        unistylesRootNode->removeUnistylesCommitTrait();
+
+        return true;
+    }
+
+    // React Native >= 0.81 commits our updates on its own, without the trait
+    // it happens synchronously on the committing thread, so commits from other threads are not ours
+    return core::UnistylesRegistry::get().trafficController.isCommitting();
+}
+
+// shadow tree changed (eg. it was scrolled), so off-screen shadow nodes may be visible now
+// idle flush places them again and commits visible ones, it's throttled to idle time
+// as hook runs for every commit, eg. every frame of an animation
+void core::UnistylesCommitHook::flushOffscreenUpdates() {
+    auto& registry = core::UnistylesRegistry::get();
+
+    // scheduled flush places pending shadow nodes anyway, so lock is not needed
+    if (registry.trafficController.isAnyFlushScheduled()) {
+        return;
+    }
+
+    auto hasDeferredUpdates = registry.trafficController.withLock([&registry](){
+        return registry.trafficController.hasPendingUpdates(shadow::ShadowLane::DEFERRED);
+    });
+
+    if (!hasDeferredUpdates || !registry.trafficController.scheduleIdleFlush()) {
+        return;
+    }
+
+    this->_runOnJSThread([](jsi::Runtime& rt){
+        shadow::ShadowTreeManager::requestIdleFlush(rt);
+    });
+}
+
+RootShadowNode::Unshared core::UnistylesCommitHook::applyUnistylesProps(
+    const ShadowTree& shadowTree,
+    const RootShadowNode::Shared& oldRootShadowNode,
+    const RootShadowNode::Unshared& newRootShadowNode
+) {
+    auto& registry = core::UnistylesRegistry::get();
+    shadow::ShadowLeafUpdates updates;
+
+    registry.trafficController.withLock([&](){
+        auto committedUpdates = registry.trafficController.getCommittedUpdates(shadowTree.getSurfaceId());
+
+        if (committedUpdates == nullptr || committedUpdates->empty()) {
+            return;
+        }
+
+        collectReclonedFamilies(*newRootShadowNode, oldRootShadowNode.get(), *committedUpdates, updates);
+
+        // shadow node is waiting for newer props, re-applying the old ones would bring back stale styles
+        // its next Unistyles commit will contain all of its props, as React dropped them
+        for (auto it = updates.begin(); it != updates.end();) {
+            if (!registry.trafficController.hasPendingUpdate(it->first)) {
+                it++;
+
+                continue;
+            }
+
+            registry.trafficController.forgetCommittedProps(shadowTree.getSurfaceId(), it->first);
+            it = updates.erase(it);
+        }
+    });
+
+    if (updates.empty()) {
+        return newRootShadowNode;
+    }
+
+    auto affectedNodes = shadow::ShadowTreeManager::findAffectedNodes(*newRootShadowNode, updates);
+
+    return std::static_pointer_cast<RootShadowNode>(shadow::ShadowTreeManager::cloneShadowTree(
+        *newRootShadowNode,
+        updates,
+        affectedNodes
+    ));
+}
+
+// walks only subtrees cloned by this commit, subtrees shared with the previous tree are untouched
+// shadow node needs Unistyles props again only if React gave it new props
+void core::UnistylesCommitHook::collectReclonedFamilies(
+    const ShadowNode& newShadowNode,
+    const ShadowNode* oldShadowNode,
+    const shadow::ShadowLeafUpdates& committedUpdates,
+    shadow::ShadowLeafUpdates& updates
+) {
+    if (&newShadowNode == oldShadowNode) {
+        return;
+    }
+
+    auto family = &newShadowNode.getFamily();
+    auto committedProps = committedUpdates.find(family);
+
+    if (committedProps != committedUpdates.end() && (oldShadowNode == nullptr || oldShadowNode->getProps() != newShadowNode.getProps())) {
+        updates.emplace(family, committedProps->second);
+    }
+
+    const auto& newChildren = newShadowNode.getChildren();
+
+    for (size_t i = 0; i < newChildren.size(); i++) {
+        const auto& newChild = newChildren[i];
+        const ShadowNode* oldChild = nullptr;
+
+        if (oldShadowNode != nullptr) {
+            const auto& oldChildren = oldShadowNode->getChildren();
+
+            // children usually keep their position, so check it first
+            if (i < oldChildren.size() && &oldChildren[i]->getFamily() == &newChild->getFamily()) {
+                oldChild = oldChildren[i].get();
+            } else {
+                auto oldChildIt = std::find_if(oldChildren.begin(), oldChildren.end(), [&newChild](const auto& child){
+                    return &child->getFamily() == &newChild->getFamily();
+                });
+
+                if (oldChildIt != oldChildren.end()) {
+                    oldChild = oldChildIt->get();
+                }
+            }
+        }
+
+        collectReclonedFamilies(*newChild, oldChild, committedUpdates, updates);
+    }
+}
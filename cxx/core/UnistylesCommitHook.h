@@ -0,0 +1,56 @@
+#pragma once
+
+#include <react/renderer/uimanager/UIManager.h>
+#include <react/renderer/uimanager/UIManagerCommitHook.h>
+#include <cxxreact/ReactNativeVersion.h>
+#include "ShadowTreeManager.h"
+#include "UnistylesCommitShadowNode.h"
+#include "UnistylesRegistry.h"
+
+namespace margelo::nitro::unistyles::core {
+
+using namespace facebook::react;
+
+// React and its re-clones don't know about Unistyles props, so this hook re-applies them
+// only to shadow nodes that were re-cloned with new props in given commit
+// React Native < 0.80 keeps them in native props instead, see ShadowTreeManager::takeShadowLeafUpdates
+// owned by UnistylesRegistry, which unregisters it on invalidate, so UIManager outlives it
+struct UnistylesCommitHook : public UIManagerCommitHook {
+    UnistylesCommitHook(UIManager& uiManager, std::function<void(std::function<void(jsi::Runtime&)>&&)> runOnJSThread)
+        : _uiManager{uiManager}, _runOnJSThread{std::move(runOnJSThread)} {
+        this->_uiManager.registerCommitHook(*this);
+    }
+
+    ~UnistylesCommitHook() noexcept override {
+        this->_uiManager.unregisterCommitHook(*this);
+    }
+
+    void commitHookWasRegistered(const UIManager& uiManager) noexcept override {}
+    void commitHookWasUnregistered(const UIManager& uiManager) noexcept override {}
+
+#if REACT_NATIVE_VERSION_MINOR >= 80
+    RootShadowNode::Unshared shadowTreeWillCommit(
+        const ShadowTree& shadowTree,
+        const RootShadowNode::Shared& oldRootShadowNode,
+        const RootShadowNode::Unshared& newRootShadowNode,
+        const ShadowTree::CommitOptions& commitOptions
+    ) noexcept override;
+#else
+    RootShadowNode::Unshared shadowTreeWillCommit(
+        const ShadowTree& shadowTree,
+        const RootShadowNode::Shared& oldRootShadowNode,
+        const RootShadowNode::Unshared& newRootShadowNode
+    ) noexcept override;
+#endif
+
+private:
+    RootShadowNode::Unshared applyUnistylesProps(const ShadowTree& shadowTree, const RootShadowNode::Shared& oldRootShadowNode, const RootShadowNode::Unshared& newRootShadowNode);
+    bool isUnistylesCommit(const RootShadowNode::Unshared& newRootShadowNode);
+    void flushOffscreenUpdates();
+    static void collectReclonedFamilies(const ShadowNode& newShadowNode, const ShadowNode* oldShadowNode, const shadow::ShadowLeafUpdates& committedUpdates, shadow::ShadowLeafUpdates& updates);
+
+    UIManager& _uiManager;
+    std::function<void(std::function<void(jsi::Runtime&)>&&)> _runOnJSThread;
+};
+
+}
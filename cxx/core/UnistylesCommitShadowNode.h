@@ -4,15 +4,25 @@
 
 namespace margelo::nitro::unistyles::core {
 
+using namespace facebook::react;
+
 // used to distinguish Unistyles commits
 // React Native uses 0-10
 // Reanimated uses 27-28
-constexpr shadow::ShadowNodeTraits::Trait UnistylesCommitTrait{1 << 30};
+constexpr ShadowNodeTraits::Trait UnistylesCommitTrait{1 << 30};
 
-struct UnistylesCommitShadowNode: public shadow::ShadowNode {
+struct UnistylesCommitShadowNode: public ShadowNode {
     inline void addUnistylesCommitTrait() {
         traits_.set(UnistylesCommitTrait);
     }
+
+    inline void removeUnistylesCommitTrait() {
+        traits_.unset(UnistylesCommitTrait);
+    }
+
+    inline bool hasUnistylesCommitTrait() {
+        return traits_.check(UnistylesCommitTrait);
+    }
 };
 
 }
@@ -1,6 +1,7 @@
 #include "UnistylesRegistry.h"
 #include "UnistylesState.h"
 #include "Parser.h"
+#include "ShadowTreeManager.h"
 
 using namespace margelo::nitro::unistyles;
 using namespace facebook;
@@ -17,6 +18,9 @@ void core::UnistylesRegistry::registerBreakpoints(jsi::Runtime& rt, std::vector<
     auto& state = this->getState(rt);
 
     state._sortedBreakpointPairs = std::move(sortedBreakpoints);
+
+    // invalidates compiled breakpoints
+    state._breakpointsGeneration++;
 }
 
 void core::UnistylesRegistry::setPrefersAdaptiveThemes(jsi::Runtime& rt, bool prefersAdaptiveThemes) {
@@ -67,19 +71,31 @@ void core::UnistylesRegistry::linkShadowNodeWithUnistyle(
     const ShadowNodeFamily* shadowNodeFamily,
     std::vector<std::shared_ptr<UnistyleData>>& unistylesData
 ) {
-    this->trafficController.withLock([this, &rt, &unistylesData, shadowNodeFamily](){
-        shadow::ShadowLeafUpdates updates;
-        auto parser = parser::Parser(nullptr);
+    shadow::ShadowLeafUpdates updates;
+    auto parser = parser::Parser(nullptr);
+    auto dependencyIndex = this->getDependencyIndex(rt);
 
-        std::for_each(unistylesData.begin(), unistylesData.end(), [this, &rt, shadowNodeFamily](std::shared_ptr<UnistyleData> unistyleData){
-            this->_shadowRegistry[&rt][shadowNodeFamily].emplace_back(unistyleData);
-        });
+    std::for_each(unistylesData.begin(), unistylesData.end(), [this, &rt, &dependencyIndex, shadowNodeFamily](std::shared_ptr<UnistyleData> unistyleData){
+        auto& unistyle = unistyleData->unistyle;
 
-        updates[shadowNodeFamily] = parser.parseStylesToShadowTreeStyles(rt, unistylesData);
+        this->_shadowRegistry[&rt][shadowNodeFamily].emplace_back(unistyleData);
 
-        this->trafficController.setUpdates(updates);
-        this->trafficController.resumeUnistylesTraffic();
+        // linked shadow node keeps StyleSheet alive
+        if (unistyle->parent != nullptr) {
+            unistyle->parent->addReference();
+        }
+
+        dependencyIndex->linkFamily(shadowNodeFamily, unistyle.get(), unistyle->dependencies);
+        unistyle->dependencyIndex = dependencyIndex;
     });
+
+    updates[shadowNodeFamily] = parser.parseStylesToShadowTreeStyles(rt, unistylesData);
+
+    this->trafficController.setUpdates(std::move(updates));
+    this->trafficController.resumeUnistylesTraffic();
+
+    // re-linked shadow node can get different styles, commit hook would keep the old ones until the next flush
+    shadow::ShadowTreeManager::scheduleShadowTreeUpdate(rt);
 }
 
 void core::UnistylesRegistry::removeDuplicatedUnistyles(jsi::Runtime& rt, const ShadowNodeFamily *shadowNodeFamily, std::vector<core::Unistyle::Shared>& unistyles) {
@@ -104,53 +120,76 @@ void core::UnistylesRegistry::removeDuplicatedUnistyles(jsi::Runtime& rt, const
 }
 
 void core::UnistylesRegistry::unlinkShadowNodeWithUnistyles(jsi::Runtime& rt, const ShadowNodeFamily* shadowNodeFamily) {
-    this->trafficController.withLock([this, &rt, shadowNodeFamily](){
-        this->_shadowRegistry[&rt].erase(shadowNodeFamily);
-        this->trafficController.removeShadowNode(shadowNodeFamily);
+    auto familyIt = this->_shadowRegistry[&rt].find(shadowNodeFamily);
+
+    if (familyIt != this->_shadowRegistry[&rt].end()) {
+        std::vector<const Unistyle*> unistyles;
+
+        unistyles.reserve(familyIt->second.size());
+
+        for (const auto& unistyleData : familyIt->second) {
+            unistyles.emplace_back(unistyleData->unistyle.get());
 
-        if (this->_shadowRegistry[&rt].empty()) {
-            this->_shadowRegistry.erase(&rt);
+            if (unistyleData->unistyle->parent != nullptr) {
+                unistyleData->unistyle->parent->removeReference();
+            }
         }
-    });
+
+        this->getDependencyIndex(rt)->unlinkFamily(shadowNodeFamily, unistyles);
+    }
+
+    this->_shadowRegistry[&rt].erase(shadowNodeFamily);
+    this->trafficController.removeShadowNode(shadowNodeFamily);
+
+    if (this->_shadowRegistry[&rt].empty()) {
+        this->_shadowRegistry.erase(&rt);
+    }
 }
 
 std::shared_ptr<core::StyleSheet> core::UnistylesRegistry::addStyleSheet(jsi::Runtime& rt, int unid, core::StyleSheetType type, jsi::Object&& rawValue) {
-    this->_styleSheetRegistry[&rt][unid] = std::make_shared<core::StyleSheet>(unid, type, std::move(rawValue));
+    // registry grows only with new StyleSheets, so it's the best moment to drop unreachable ones
+    this->collectStyleSheets(rt);
+
+    auto& styleSheets = this->_styleSheetRegistry[&rt];
+    auto existingStyleSheetIt = styleSheets.find(unid);
+
+    // StyleSheet is being replaced (eg. Fast Refresh), its unistyles are no longer reachable by id
+    if (existingStyleSheetIt != styleSheets.end()) {
+        auto& unistylesIndex = this->_unistylesIndex[&rt];
 
-    return this->_styleSheetRegistry[&rt][unid];
+        for (const auto& [_, unistyle] : existingStyleSheetIt->second->unistyles) {
+            unistylesIndex.erase(unistyle->unid);
+        }
+    }
+
+    styleSheets[unid] = std::make_shared<core::StyleSheet>(unid, type, std::move(rawValue));
+
+    return styleSheets[unid];
 }
 
-core::DependencyMap core::UnistylesRegistry::buildDependencyMap(jsi::Runtime& rt, std::vector<UnistyleDependency>& deps) {
+core::DependencyMap core::UnistylesRegistry::buildDependencyMap(jsi::Runtime& rt, helpers::DependencyMask deps) {
     core::DependencyMap dependencyMap;
 
-    std::unordered_set<UnistyleDependency> uniqueDependencies(deps.begin(), deps.end());
+    auto indexIt = this->_dependencyIndexes.find(&rt);
 
-    for (const auto& [family, unistyles] : this->_shadowRegistry[&rt]) {
-        bool hasAnyOfDependencies = false;
-
-        // Check if any dependency matches
-        for (const auto& unistyleData : unistyles) {
-            for (const auto& dep : unistyleData->unistyle->dependencies) {
-                if (uniqueDependencies.count(dep)) {
-                    hasAnyOfDependencies = true;
-                    break;
-                }
-            }
+    if (indexIt == this->_dependencyIndexes.end()) {
+        return dependencyMap;
+    }
 
-            if (hasAnyOfDependencies) {
-                break;
-            };
-        }
+    // visit only families that depend on any of given dependencies
+    auto& shadowRegistry = this->_shadowRegistry[&rt];
+    auto affectedFamilies = indexIt->second->getFamilies(deps);
+
+    dependencyMap.reserve(affectedFamilies.size());
+
+    for (const auto* family : affectedFamilies) {
+        auto familyIt = shadowRegistry.find(family);
 
-        if (!hasAnyOfDependencies) {
+        if (familyIt == shadowRegistry.end()) {
             continue;
         }
 
-        dependencyMap[family].insert(
-            dependencyMap[family].end(),
-            unistyles.begin(),
-            unistyles.end()
-        );
+        dependencyMap.emplace(family, familyIt->second);
     }
 
     return dependencyMap;
@@ -160,57 +199,43 @@ core::DependencyMap core::UnistylesRegistry::buildDependencyMap(jsi::Runtime& rt
 // so we need to rebuild all instances as they may have different variants
 void core::UnistylesRegistry::shadowLeafUpdateFromUnistyle(jsi::Runtime& rt, Unistyle::Shared unistyle, jsi::Value& maybePressableId) {
     shadow::ShadowLeafUpdates updates;
-    this->trafficController.withLock([this, &rt, &maybePressableId, unistyle, &updates](){
-        auto parser = parser::Parser(nullptr);
-        std::optional<std::string> pressableId = maybePressableId.isString()
-            ? std::make_optional(maybePressableId.asString(rt).utf8(rt))
-            : std::nullopt;
-
-        for (const auto& [family, unistyles] : this->_shadowRegistry[&rt]) {
-            for (const auto& unistyleData : unistyles) {
-                if (unistyleData->unistyle == unistyle) {
-                    updates[family] = parser.parseStylesToShadowTreeStyles(rt, { unistyleData });
-                }
-            }
+    auto parser = parser::Parser(nullptr);
+    std::optional<std::string> pressableId = maybePressableId.isString()
+        ? std::make_optional(maybePressableId.asString(rt).utf8(rt))
+        : std::nullopt;
+
+    for (const auto& [family, unistyles] : this->_shadowRegistry[&rt]) {
+        auto isAffected = std::any_of(unistyles.begin(), unistyles.end(), [&unistyle](const std::shared_ptr<UnistyleData>& unistyleData){
+            return unistyleData->unistyle == unistyle;
+        });
+
+        // recomputed unistyle could drop some keys, other styles of the shadow node may still set them
+        // so the whole style is flattened again and replaces the previous one
+        if (isAffected) {
+            updates[family] = parser.parseStylesToShadowTreeStyles(rt, unistyles);
         }
+    }
 
-        this->trafficController.setUpdates(updates);
-    });
+    this->trafficController.setUpdates(std::move(updates));
 }
 
-std::vector<std::shared_ptr<core::StyleSheet>>core::UnistylesRegistry::getStyleSheetsToRefresh(jsi::Runtime& rt, std::vector<UnistyleDependency>& unistylesDependencies) {
+std::vector<std::shared_ptr<core::StyleSheet>>core::UnistylesRegistry::getStyleSheetsToRefresh(jsi::Runtime& rt, helpers::DependencyMask unistylesDependencies) {
     std::vector<std::shared_ptr<core::StyleSheet>> stylesheetsToRefresh;
-    std::unordered_set<UnistyleDependency> depSet(
-        unistylesDependencies.begin(),
-        unistylesDependencies.end()
-    );
 
-    bool themeDidChange = depSet.count(UnistyleDependency::THEME) > 0;
-    bool runtimeDidChange = (themeDidChange && depSet.size() > 1) || !depSet.empty();
-
-    if (!themeDidChange && !runtimeDidChange) {
+    if (unistylesDependencies.empty()) {
         return stylesheetsToRefresh;
     }
 
+    // don't rebuild StyleSheets that no one can use
+    this->collectStyleSheets(rt);
+
+    bool themeDidChange = unistylesDependencies.contains(UnistyleDependency::THEME);
     auto& styleSheets = this->_styleSheetRegistry[&rt];
 
     for (const auto& [_, styleSheet] : styleSheets) {
-        if (styleSheet->type == StyleSheetType::ThemableWithMiniRuntime) {
-            auto hasMatchingDependency = [&depSet](const auto& unistyles) {
-                for (const auto& [_, unistyle] : unistyles) {
-                    for (const auto& dep : unistyle->dependencies) {
-                        if (depSet.count(dep)) {
-                            return true;
-                        }
-                    }
-                }
-
-                return false;
-            };
-
-            if (hasMatchingDependency(styleSheet->unistyles)) {
-                stylesheetsToRefresh.emplace_back(styleSheet);
-            }
+        // StyleSheet summarizes dependencies of all its unistyles
+        if (styleSheet->type == StyleSheetType::ThemableWithMiniRuntime && styleSheet->dependencies.intersects(unistylesDependencies)) {
+            stylesheetsToRefresh.emplace_back(styleSheet);
         }
 
         if (styleSheet->type == StyleSheetType::Themable && themeDidChange) {
@@ -221,20 +246,127 @@ std::vector<std::shared_ptr<core::StyleSheet>>core::UnistylesRegistry::getStyleS
     return stylesheetsToRefresh;
 }
 
-core::Unistyle::Shared core::UnistylesRegistry::getUnistyleById(jsi::Runtime& rt, std::string unistyleID) {
-    for (auto& pair: this->_styleSheetRegistry[&rt]) {
-        auto [_, stylesheet] = pair;
+void core::UnistylesRegistry::indexUnistyles(jsi::Runtime& rt, std::shared_ptr<core::StyleSheet> styleSheet) {
+    auto& unistylesIndex = this->_unistylesIndex[&rt];
 
-        for (auto unistylePair: stylesheet->unistyles) {
-            auto [_, unistyle] = unistylePair;
+    unistylesIndex.reserve(unistylesIndex.size() + styleSheet->unistyles.size());
 
-            if (unistyle->unid == unistyleID) {
-                return unistyle;
-            }
+    for (const auto& [_, unistyle] : styleSheet->unistyles) {
+        unistylesIndex.insert_or_assign(unistyle->unid, unistyle);
+    }
+}
+
+core::Unistyle::Shared core::UnistylesRegistry::getUnistyleById(jsi::Runtime& rt, helpers::Unid unid) {
+    auto runtimeIt = this->_unistylesIndex.find(&rt);
+
+    if (runtimeIt == this->_unistylesIndex.end()) {
+        return nullptr;
+    }
+
+    auto unistyleIt = runtimeIt->second.find(unid);
+
+    if (unistyleIt == runtimeIt->second.end()) {
+        return nullptr;
+    }
+
+    return unistyleIt->second.lock();
+}
+
+void core::UnistylesRegistry::releaseStyleSheet(jsi::Runtime& rt, int tag) {
+    auto runtimeIt = this->_styleSheetRegistry.find(&rt);
+
+    if (runtimeIt == this->_styleSheetRegistry.end()) {
+        return;
+    }
+
+    auto styleSheetIt = runtimeIt->second.find(tag);
+
+    if (styleSheetIt == runtimeIt->second.end()) {
+        return;
+    }
+
+    styleSheetIt->second->isReleased = true;
+
+    this->collectStyleSheets(rt);
+}
+
+void core::UnistylesRegistry::collectStyleSheets(jsi::Runtime& rt) {
+    auto runtimeIt = this->_styleSheetRegistry.find(&rt);
+
+    if (runtimeIt == this->_styleSheetRegistry.end()) {
+        return;
+    }
+
+    auto& styleSheets = runtimeIt->second;
+    auto didEvict = false;
+
+    for (auto it = styleSheets.begin(); it != styleSheets.end();) {
+        if (!it->second->canBeEvicted()) {
+            it++;
+
+            continue;
+        }
+
+        this->evictStyleSheet(rt, it->second);
+
+        it = styleSheets.erase(it);
+        didEvict = true;
+    }
+
+    if (didEvict) {
+        this->pruneUnistylesIndex(rt);
+    }
+}
+
+// StyleSheet and its unistyles reference each other, so the cycle is broken here
+// mounted shadow nodes and style objects still own their unistyles, and they keep updating until unmounted
+void core::UnistylesRegistry::evictStyleSheet(jsi::Runtime& rt, std::shared_ptr<core::StyleSheet> styleSheet) {
+    styleSheet->unistyles.clear();
+    this->_evictedStyleSheets++;
+}
+
+// unistyles of evicted StyleSheets stay reachable by id (eg. spread styles) as long as someone owns them
+void core::UnistylesRegistry::pruneUnistylesIndex(jsi::Runtime& rt) {
+    auto& unistylesIndex = this->_unistylesIndex[&rt];
+
+    for (auto it = unistylesIndex.begin(); it != unistylesIndex.end();) {
+        if (it->second.expired()) {
+            it = unistylesIndex.erase(it);
+
+            continue;
         }
+
+        it++;
+    }
+}
+
+core::StyleSheetRegistryStats core::UnistylesRegistry::getStyleSheetRegistryStats(jsi::Runtime& rt) {
+    StyleSheetRegistryStats stats{};
+
+    stats.evictedStyleSheets = this->_evictedStyleSheets;
+
+    auto styleSheetsIt = this->_styleSheetRegistry.find(&rt);
+    auto unistylesIt = this->_unistylesIndex.find(&rt);
+
+    if (styleSheetsIt != this->_styleSheetRegistry.end()) {
+        stats.styleSheets = styleSheetsIt->second.size();
+    }
+
+    if (unistylesIt != this->_unistylesIndex.end()) {
+        stats.unistyles = unistylesIt->second.size();
     }
 
-    return nullptr;
+    return stats;
+}
+
+std::shared_ptr<core::DependencyIndex> core::UnistylesRegistry::getDependencyIndex(jsi::Runtime& rt) {
+    auto it = this->_dependencyIndexes.find(&rt);
+
+    if (it == this->_dependencyIndexes.end()) {
+        it = this->_dependencyIndexes.emplace(&rt, std::make_shared<DependencyIndex>()).first;
+    }
+
+    return it->second;
 }
 
 const std::optional<std::string> core::UnistylesRegistry::getScopedTheme() {
@@ -245,9 +377,21 @@ void core::UnistylesRegistry::setScopedTheme(std::optional<std::string> themeNam
     this->_scopedTheme = std::move(themeName);
 }
 
+void core::UnistylesRegistry::setCommitHook(std::shared_ptr<UIManagerCommitHook> commitHook) {
+    this->_commitHook = std::move(commitHook);
+}
+
 void core::UnistylesRegistry::destroy() {
+    // unregisters commit hook
+    this->_commitHook = nullptr;
+    this->trafficController.withLock([this](){
+        this->trafficController.restore();
+    });
     this->_states.clear();
     this->_styleSheetRegistry.clear();
     this->_shadowRegistry.clear();
+    this->_dependencyIndexes.clear();
+    this->_unistylesIndex.clear();
     this->_scopedTheme = std::nullopt;
+    this->_evictedStyleSheets = 0;
 }
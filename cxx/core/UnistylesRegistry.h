@@ -4,6 +4,7 @@
 #include <jsi/jsi.h>
 #include <folly/dynamic.h>
 #include <react/renderer/uimanager/UIManager.h>
+#include <react/renderer/uimanager/UIManagerCommitHook.h>
 #include <unordered_map>
 #include <unordered_set>
 #include "Breakpoints.h"
@@ -11,6 +12,8 @@
 #include "StyleSheet.h"
 #include "Unistyle.h"
 #include "UnistyleData.h"
+#include "DependencyIndex.h"
+#include "DependencyMask.h"
 #include "ShadowTrafficController.h"
 
 namespace margelo::nitro::unistyles::core {
@@ -22,6 +25,12 @@ using namespace facebook::react;
 
 using DependencyMap = std::unordered_map<const ShadowNodeFamily*, std::vector<std::shared_ptr<UnistyleData>>>;
 
+struct StyleSheetRegistryStats {
+    size_t styleSheets = 0;
+    size_t unistyles = 0;
+    size_t evictedStyleSheets = 0;
+};
+
 struct UnistylesRegistry: public StyleSheetRegistry {
     static UnistylesRegistry& get();
 
@@ -29,6 +38,10 @@ struct UnistylesRegistry: public StyleSheetRegistry {
     UnistylesRegistry(const UnistylesRegistry&&) = delete;
 
     bool shouldUsePointsForBreakpoints = false;
+    // 0 means that shadow tree updates are committed once per frame
+    double commitInterval = 0;
+    // 0 means that big updates are committed at once, otherwise in chunks within this per frame budget
+    double commitBudget = 0;
 
     void registerTheme(jsi::Runtime& rt, std::string name, jsi::Value& theme);
     void registerBreakpoints(jsi::Runtime& rt, std::vector<std::pair<std::string, double>>& sortedBreakpoints);
@@ -38,26 +51,40 @@ struct UnistylesRegistry: public StyleSheetRegistry {
 
     UnistylesState& getState(jsi::Runtime& rt);
     void createState(jsi::Runtime& rt);
-    std::vector<std::shared_ptr<core::StyleSheet>> getStyleSheetsToRefresh(jsi::Runtime& rt, std::vector<UnistyleDependency>& unistylesDependencies);
+    std::vector<std::shared_ptr<core::StyleSheet>> getStyleSheetsToRefresh(jsi::Runtime& rt, helpers::DependencyMask unistylesDependencies);
     void linkShadowNodeWithUnistyle(jsi::Runtime& rt, const ShadowNodeFamily*, std::vector<std::shared_ptr<UnistyleData>>& unistylesData);
     void unlinkShadowNodeWithUnistyles(jsi::Runtime& rt, const ShadowNodeFamily*);
     std::shared_ptr<core::StyleSheet> addStyleSheet(jsi::Runtime& rt, int tag, core::StyleSheetType type, jsi::Object&& rawValue);
-    DependencyMap buildDependencyMap(jsi::Runtime& rt, std::vector<UnistyleDependency>& deps);
+    DependencyMap buildDependencyMap(jsi::Runtime& rt, helpers::DependencyMask deps);
     void shadowLeafUpdateFromUnistyle(jsi::Runtime& rt, Unistyle::Shared unistyle, jsi::Value& maybePressableId);
     shadow::ShadowTrafficController trafficController{};
     const std::optional<std::string> getScopedTheme();
     void removeDuplicatedUnistyles(jsi::Runtime& rt, const ShadowNodeFamily* shadowNodeFamily, std::vector<core::Unistyle::Shared>& unistyles);
     void setScopedTheme(std::optional<std::string> themeName);
-    core::Unistyle::Shared getUnistyleById(jsi::Runtime& rt, std::string unistyleID);
+    void indexUnistyles(jsi::Runtime& rt, std::shared_ptr<core::StyleSheet> styleSheet);
+    core::Unistyle::Shared getUnistyleById(jsi::Runtime& rt, helpers::Unid unid);
+    void releaseStyleSheet(jsi::Runtime& rt, int tag);
+    void collectStyleSheets(jsi::Runtime& rt);
+    StyleSheetRegistryStats getStyleSheetRegistryStats(jsi::Runtime& rt);
+    void setCommitHook(std::shared_ptr<UIManagerCommitHook> commitHook);
     void destroy();
 
 private:
     UnistylesRegistry() = default;
 
+    std::shared_ptr<DependencyIndex> getDependencyIndex(jsi::Runtime& rt);
+    void evictStyleSheet(jsi::Runtime& rt, std::shared_ptr<core::StyleSheet> styleSheet);
+    void pruneUnistylesIndex(jsi::Runtime& rt);
+
     std::optional<std::string> _scopedTheme{};
+    size_t _evictedStyleSheets = 0;
+    // owned here, so it's unregistered on invalidate, before UIManager goes away
+    std::shared_ptr<UIManagerCommitHook> _commitHook{};
     std::unordered_map<jsi::Runtime*, UnistylesState> _states{};
     std::unordered_map<jsi::Runtime*, std::unordered_map<int, std::shared_ptr<core::StyleSheet>>> _styleSheetRegistry{};
     std::unordered_map<jsi::Runtime*, std::unordered_map<const ShadowNodeFamily*, std::vector<std::shared_ptr<UnistyleData>>>> _shadowRegistry{};
+    std::unordered_map<jsi::Runtime*, std::shared_ptr<DependencyIndex>> _dependencyIndexes{};
+    std::unordered_map<jsi::Runtime*, std::unordered_map<helpers::Unid, std::weak_ptr<Unistyle>>> _unistylesIndex{};
 };
 
 inline UnistylesRegistry& UnistylesRegistry::get() {
@@ -1,5 +1,7 @@
 #include "UnistylesState.h"
 #include "UnistylesRegistry.h"
+#include "ColorParser.h"
+#include "BoxShadowParser.h"
 
 using namespace margelo::nitro::unistyles;
 
@@ -57,10 +59,11 @@ void core::UnistylesState::computeCurrentBreakpoint(int screenWidth) {
         return;
     }
 
-    this->_currentBreakpointName = helpers::getBreakpointFromScreenWidth(
+    this->_currentBreakpointIndex = helpers::getBreakpointIndexFromScreenWidth(
         screenWidth,
         this->_sortedBreakpointPairs
     );
+    this->_currentBreakpointName = this->_sortedBreakpointPairs[this->_currentBreakpointIndex.value()].first;
 }
 
 bool core::UnistylesState::hasTheme(std::string themeName) {
@@ -75,8 +78,12 @@ std::vector<std::string> core::UnistylesState::getRegisteredThemeNames() {
     return std::vector<std::string>(this->_registeredThemeNames);
 }
 
-std::vector<std::pair<std::string, double>> core::UnistylesState::getSortedBreakpointPairs() {
-    return std::vector<std::pair<std::string, double>>(this->_sortedBreakpointPairs);
+const std::vector<std::pair<std::string, double>>& core::UnistylesState::getSortedBreakpointPairs() {
+    return this->_sortedBreakpointPairs;
+}
+
+size_t core::UnistylesState::getBreakpointsGeneration() {
+    return this->_breakpointsGeneration;
 }
 
 std::optional<std::string> core::UnistylesState::getInitialTheme() {
@@ -87,6 +94,10 @@ std::optional<std::string> core::UnistylesState::getCurrentBreakpointName() {
     return this->_currentBreakpointName;
 }
 
+std::optional<size_t> core::UnistylesState::getCurrentBreakpointIndex() {
+    return this->_currentBreakpointIndex;
+}
+
 bool core::UnistylesState::getPrefersAdaptiveThemes() {
     return this->_prefersAdaptiveThemes.has_value() && this->_prefersAdaptiveThemes.value();
 }
@@ -95,8 +106,8 @@ void core::UnistylesState::registerProcessColorFunction(jsi::Function&& fn) {
     this->_processColorFn = std::make_shared<jsi::Function>(std::move(fn));
 }
 
-void core::UnistylesState::registerParseBoxShadowString(jsi::Function&& fn) {
-    this->_parseBoxShadowStringFn = std::make_shared<jsi::Function>(std::move(fn));
+core::PropertyTable& core::UnistylesState::getPropertyTable() {
+    return this->_propertyTable;
 }
 
 int core::UnistylesState::parseColor(jsi::Value& maybeColor) {
@@ -104,23 +115,77 @@ int core::UnistylesState::parseColor(jsi::Value& maybeColor) {
         return 0;
     }
 
-    auto colorString = maybeColor.asString(*_rt);
+    auto colorString = maybeColor.asString(*_rt).utf8(*_rt);
+    auto it = this->_colorCache.find(colorString);
+
+    if (it != this->_colorCache.end()) {
+        return it->second;
+    }
+
+    // fallback to JS only for formats that native parser doesn't handle
+    auto nativeColor = parser::ColorParser::processColor(colorString);
+    uint32_t color = nativeColor.has_value()
+        ? nativeColor.value()
+        : this->processColorInJS(colorString);
+
+    this->_colorCache.emplace(std::move(colorString), color);
+
+    return color;
+}
+
+uint32_t core::UnistylesState::processColorInJS(const std::string& colorString) {
+    #ifdef ANDROID
+        int color = this->_processColorFn.get()->call(*_rt, jsi::String::createFromUtf8(*_rt, colorString)).asNumber();
+    #else
+        uint32_t color = this->_processColorFn.get()->call(*_rt, jsi::String::createFromUtf8(*_rt, colorString)).asNumber();
+    #endif
 
-    if (!this->_colorCache.contains(colorString.utf8(*_rt).c_str())) {
-        #ifdef ANDROID
-            int color = this->_processColorFn.get()->call(*_rt, colorString).asNumber();
-        #else
-            uint32_t color = this->_processColorFn.get()->call(*_rt, colorString).asNumber();
-        #endif
+    return color ? color : 0;
+}
+
+bool core::UnistylesState::isValidColor(const std::string& colorString) {
+    auto nativeColor = parser::ColorParser::processColor(colorString);
 
-        this->_colorCache[colorString.utf8(*_rt).c_str()] = color ? color : 0;
+    // mimics JS truthy check, so transparent is not a valid color
+    if (nativeColor.has_value()) {
+        return nativeColor.value() != 0;
     }
 
-    return this->_colorCache[colorString.utf8(*_rt).c_str()];
+    auto color = this->_processColorFn.get()->call(*_rt, jsi::String::createFromUtf8(*_rt, colorString));
+
+    return color.isNumber() && color.asNumber() != 0;
 }
 
 jsi::Array core::UnistylesState::parseBoxShadowString(std::string&& boxShadowString) {
-    jsi::Value result = this->_parseBoxShadowStringFn.get()->call(*_rt, boxShadowString);
+    auto it = this->_boxShadowCache.find(boxShadowString);
+
+    if (it == this->_boxShadowCache.end()) {
+        auto boxShadows = parser::BoxShadowParser::parse(boxShadowString, [this](const std::string& color){
+            return this->isValidColor(color);
+        });
+
+        it = this->_boxShadowCache.emplace(std::move(boxShadowString), std::move(boxShadows)).first;
+    }
+
+    auto& boxShadows = it->second;
+    jsi::Array result = jsi::Array(*_rt, boxShadows.size());
+
+    for (size_t i = 0; i < boxShadows.size(); i++) {
+        auto& boxShadow = boxShadows[i];
+        jsi::Object parsedBoxShadow = jsi::Object(*_rt);
+
+        parsedBoxShadow.setProperty(*_rt, "inset", boxShadow.inset ? jsi::Value(true) : jsi::Value::undefined());
+        parsedBoxShadow.setProperty(*_rt, "offsetX", boxShadow.offsetX);
+        parsedBoxShadow.setProperty(*_rt, "offsetY", boxShadow.offsetY);
+        parsedBoxShadow.setProperty(*_rt, "blurRadius", boxShadow.blurRadius);
+        parsedBoxShadow.setProperty(*_rt, "spreadDistance", boxShadow.spreadDistance);
+        parsedBoxShadow.setProperty(*_rt, "color", boxShadow.color.has_value()
+            ? jsi::Value(jsi::String::createFromUtf8(*_rt, boxShadow.color.value()))
+            : jsi::Value::undefined()
+        );
+
+        result.setValueAtIndex(*_rt, i, parsedBoxShadow);
+    }
 
-    return result.asObject(*_rt).asArray(*_rt);
+    return result;
 }
@@ -5,6 +5,8 @@
 #include <jsi/jsi.h>
 #include <vector>
 #include "Helpers.h"
+#include "BoxShadowParser.h"
+#include "PropertyTable.h"
 
 namespace margelo::nitro::unistyles::core {
 
@@ -13,7 +15,7 @@ struct UnistylesRegistry;
 using namespace facebook;
 
 struct UnistylesState {
-    UnistylesState(jsi::Runtime& rt): _rt{&rt} {}
+    UnistylesState(jsi::Runtime& rt): _rt{&rt}, _propertyTable{rt} {}
     UnistylesState(const UnistylesState&) = delete;
     UnistylesState(const UnistylesState&&) = delete;
 
@@ -27,7 +29,9 @@ struct UnistylesState {
     std::vector<std::string> getRegisteredThemeNames();
     std::optional<std::string> getInitialTheme();
     std::optional<std::string> getCurrentBreakpointName();
-    std::vector<std::pair<std::string, double>> getSortedBreakpointPairs();
+    std::optional<size_t> getCurrentBreakpointIndex();
+    const std::vector<std::pair<std::string, double>>& getSortedBreakpointPairs();
+    size_t getBreakpointsGeneration();
 
     jsi::Object getCurrentJSTheme();
     jsi::Object getJSThemeByName(std::string& themeName);
@@ -35,20 +39,26 @@ struct UnistylesState {
     jsi::Array parseBoxShadowString(std::string&& boxShadowString);
     void computeCurrentBreakpoint(int screenWidth);
     void registerProcessColorFunction(jsi::Function&& fn);
-    void registerParseBoxShadowString(jsi::Function&& fn);
+    PropertyTable& getPropertyTable();
 
 private:
     jsi::Runtime* _rt;
+    PropertyTable _propertyTable;
     std::unordered_map<std::string, jsi::Value> _jsThemes{};
     std::optional<bool> _prefersAdaptiveThemes = std::nullopt;
     std::optional<std::string> _initialThemeName = std::nullopt;
     std::optional<std::string> _currentBreakpointName = std::nullopt;
+    std::optional<size_t> _currentBreakpointIndex = std::nullopt;
+    size_t _breakpointsGeneration = 0;
     std::vector<std::pair<std::string, double>> _sortedBreakpointPairs{};
     std::vector<std::string> _registeredThemeNames{};
     std::optional<std::string> _currentThemeName = std::nullopt;
     std::shared_ptr<jsi::Function> _processColorFn;
-    std::shared_ptr<jsi::Function> _parseBoxShadowStringFn;
     std::unordered_map<std::string, uint32_t> _colorCache{};
+    std::unordered_map<std::string, std::vector<parser::BoxShadow>> _boxShadowCache{};
+
+    uint32_t processColorInJS(const std::string& colorString);
+    bool isValidColor(const std::string& colorString);
 
     friend class UnistylesRegistry;
 };
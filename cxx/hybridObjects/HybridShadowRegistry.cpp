@@ -68,7 +68,7 @@ jsi::Value HybridShadowRegistry::link(jsi::Runtime &rt, const jsi::Value &thisVa
             }
         }
 
-        std::shared_ptr<core::UnistyleData> unistyleData = std::make_shared<core::UnistyleData>(
+        std::shared_ptr<core::UnistyleData> unistyleData = helpers::makePooled<core::UnistyleData>(
             unistyle,
             variants,
             arguments[i],
@@ -108,11 +108,28 @@ jsi::Value HybridShadowRegistry::unlink(jsi::Runtime &rt, const jsi::Value &this
 }
 
 jsi::Value HybridShadowRegistry::flush(jsi::Runtime &rt, const jsi::Value &thisValue, const jsi::Value *args, size_t count) {
+    // commits immediately, even if there is a scheduled flush
     shadow::ShadowTreeManager::updateShadowTree(rt);
 
     return jsi::Value::undefined();
 }
 
+jsi::Value HybridShadowRegistry::getCommitStats(jsi::Runtime &rt, const jsi::Value &thisValue, const jsi::Value *args, size_t count) {
+    auto& registry = core::UnistylesRegistry::get();
+    auto stats = registry.trafficController.withLock([&registry](){
+        return registry.trafficController.getStats();
+    });
+    jsi::Object commitStats = jsi::Object(rt);
+
+    commitStats.setProperty(rt, "receivedUpdates", static_cast<double>(stats.receivedUpdates));
+    commitStats.setProperty(rt, "mergedUpdates", static_cast<double>(stats.mergedUpdates));
+    commitStats.setProperty(rt, "coalescedFlushes", static_cast<double>(stats.coalescedFlushes));
+    commitStats.setProperty(rt, "unchangedUpdates", static_cast<double>(stats.unchangedUpdates));
+    commitStats.setProperty(rt, "commits", static_cast<double>(stats.commits));
+
+    return commitStats;
+}
+
 jsi::Value HybridShadowRegistry::setScopedTheme(jsi::Runtime &rt, const jsi::Value &thisValue, const jsi::Value *args, size_t count) {
     helpers::assertThat(rt, count == 1, "Unistyles: setScopedTheme expected 1 argument.");
 
@@ -40,6 +40,8 @@ jsi::Value HybridStyleSheet::create(jsi::Runtime& rt, const jsi::Value &thisVal,
     parser.buildUnistyles(rt, registeredStyleSheet);
     parser.parseUnistyles(rt, registeredStyleSheet);
 
+    registry.indexUnistyles(rt, registeredStyleSheet);
+
     return core::toRNStyle(rt, registeredStyleSheet, this->_unistylesRuntime, {});
 }
 
@@ -80,6 +82,30 @@ jsi::Value HybridStyleSheet::configure(jsi::Runtime &rt, const jsi::Value &thisV
     return jsi::Value::undefined();
 }
 
+jsi::Value HybridStyleSheet::release(jsi::Runtime &rt, const jsi::Value &thisVal, const jsi::Value *arguments, size_t count) {
+    helpers::assertThat(rt, count == 1, "StyleSheet.release expected to be called with one argument.");
+    helpers::assertThat(rt, arguments[0].isObject(), "StyleSheet.release expected to be called with object returned from StyleSheet.create.");
+
+    auto styleSheetId = arguments[0].asObject(rt).getProperty(rt, helpers::STYLESHEET_ID.c_str());
+
+    helpers::assertThat(rt, styleSheetId.isNumber(), "StyleSheet.release expected to be called with object returned from StyleSheet.create.");
+
+    core::UnistylesRegistry::get().releaseStyleSheet(rt, styleSheetId.asNumber());
+
+    return jsi::Value::undefined();
+}
+
+jsi::Value HybridStyleSheet::getRegistryStats(jsi::Runtime &rt, const jsi::Value &thisVal, const jsi::Value *arguments, size_t count) {
+    auto stats = core::UnistylesRegistry::get().getStyleSheetRegistryStats(rt);
+    jsi::Object registryStats = jsi::Object(rt);
+
+    registryStats.setProperty(rt, "styleSheets", static_cast<double>(stats.styleSheets));
+    registryStats.setProperty(rt, "unistyles", static_cast<double>(stats.unistyles));
+    registryStats.setProperty(rt, "evictedStyleSheets", static_cast<double>(stats.evictedStyleSheets));
+
+    return registryStats;
+}
+
 jsi::Value HybridStyleSheet::init(jsi::Runtime &rt, const jsi::Value &thisVal, const jsi::Value *arguments, size_t count) {
     if (this->isInitialized) {
         return jsi::Value::undefined();
@@ -92,6 +118,12 @@ jsi::Value HybridStyleSheet::init(jsi::Runtime &rt, const jsi::Value &thisVal, c
 
     loadExternalMethods(thisVal, rt);
 
+    // keeps Unistyles props alive across React commits and commits shadow nodes that scrolled into view
+    core::UnistylesRegistry::get().setCommitHook(std::make_shared<core::UnistylesCommitHook>(
+        UIManagerBinding::getBinding(rt)->getUIManager(),
+        this->_unistylesRuntime->runOnJSThread
+    ));
+
     this->isInitialized = true;
 
     return jsi::Value::undefined();
@@ -145,6 +177,22 @@ void HybridStyleSheet::parseSettings(jsi::Runtime &rt, jsi::Object settings) {
             return;
         }
 
+        if (propertyName == "commitInterval") {
+            helpers::assertThat(rt, propertyValue.isNumber() && propertyValue.asNumber() >= 0, "StyleSheet.configure's commitInterval must be a non-negative number");
+
+            registry.commitInterval = propertyValue.asNumber();
+
+            return;
+        }
+
+        if (propertyName == "commitBudget") {
+            helpers::assertThat(rt, propertyValue.isNumber() && propertyValue.asNumber() >= 0, "StyleSheet.configure's commitBudget must be a non-negative number");
+
+            registry.commitBudget = propertyValue.asNumber();
+
+            return;
+        }
+
         helpers::assertThat(rt, false, "StyleSheet.configure's settings received unexpected key: '" + std::string(propertyName) + "'");
     });
 }
@@ -251,18 +299,12 @@ void HybridStyleSheet::loadExternalMethods(const jsi::Value& thisValue, jsi::Run
     auto maybeProcessColorFn = jsMethods.asObject(rt).getProperty(rt, "processColor");
 
     helpers::assertThat(rt, maybeProcessColorFn.isObject(), "Unistyles: Can't load processColor function from JS.");
-    
-    auto maybeParseBoxShadowStringFn = jsMethods.asObject(rt).getProperty(rt, "parseBoxShadowString");
-    
-    helpers::assertThat(rt, maybeParseBoxShadowStringFn.isObject(), "Unistyles: Can't load parseBoxShadowString function from JS.");
 
     auto processColorFn = maybeProcessColorFn.asObject(rt).asFunction(rt);
-    auto parseBoxShadowStringFn = maybeParseBoxShadowStringFn.asObject(rt).asFunction(rt);
     auto& registry = core::UnistylesRegistry::get();
     auto& state = registry.getState(rt);
 
     state.registerProcessColorFunction(std::move(processColorFn));
-    state.registerParseBoxShadowString(std::move(parseBoxShadowStringFn));
 }
 
 void HybridStyleSheet::onPlatformDependenciesChange(std::vector<UnistyleDependency> dependencies) {
@@ -274,7 +316,8 @@ void HybridStyleSheet::onPlatformDependenciesChange(std::vector<UnistyleDependen
     auto& registry = core::UnistylesRegistry::get();
     auto& rt = this->_unistylesRuntime->getRuntime();
     auto parser = parser::Parser(this->_unistylesRuntime);
-    auto dependencyMap = registry.buildDependencyMap(rt, dependencies);
+    auto dependencyMask = helpers::DependencyMask(dependencies);
+    auto dependencyMap = registry.buildDependencyMap(rt, dependencyMask);
 
     if (dependencyMap.empty()) {
         this->notifyJSListeners(dependencies);
@@ -283,7 +326,7 @@ void HybridStyleSheet::onPlatformDependenciesChange(std::vector<UnistyleDependen
     // in a later step, we will rebuild only Unistyles with mounted StyleSheets
     // however, user may have StyleSheets with components that haven't mounted yet
     // we need to rebuild all dependent StyleSheets as well
-    auto dependentStyleSheets = registry.getStyleSheetsToRefresh(rt, dependencies);
+    auto dependentStyleSheets = registry.getStyleSheetsToRefresh(rt, dependencyMask);
 
     parser.rebuildUnistylesInDependencyMap(rt, dependencyMap, dependentStyleSheets, std::nullopt);
 
@@ -293,10 +336,9 @@ void HybridStyleSheet::onPlatformDependenciesChange(std::vector<UnistyleDependen
         return;
     }
 
-    parser.rebuildShadowLeafUpdates(rt, dependencyMap);
+    parser.rebuildShadowLeafUpdates(rt, dependencyMap, shadow::getShadowLane(dependencyMask));
 
-    this->notifyJSListeners(dependencies);
-    shadow::ShadowTreeManager::updateShadowTree(rt);
+    this->scheduleShadowTreeUpdate(rt, dependencies);
 }
 
 void HybridStyleSheet::onPlatformNativeDependenciesChange(std::vector<UnistyleDependency> dependencies, UnistylesNativeMiniRuntime miniRuntime) {
@@ -309,11 +351,10 @@ void HybridStyleSheet::onPlatformNativeDependenciesChange(std::vector<UnistyleDe
         auto& registry = core::UnistylesRegistry::get();
         auto parser = parser::Parser(this->_unistylesRuntime);
         auto unistyleDependencies = std::move(dependencies);
+        auto nativeDependencyMask = helpers::DependencyMask(unistyleDependencies);
 
         // re-compute new breakpoint
-        auto dimensionsIt = std::find(dependencies.begin(), dependencies.end(), UnistyleDependency::DIMENSIONS);
-
-        if (dimensionsIt != dependencies.end()) {
+        if (nativeDependencyMask.contains(UnistyleDependency::DIMENSIONS)) {
             auto rawWidth = this->_unistylesRuntime->getScreen().width;
             auto width = registry.shouldUsePointsForBreakpoints
                 ? rawWidth / this->_unistylesRuntime->getPixelRatio()
@@ -323,14 +364,14 @@ void HybridStyleSheet::onPlatformNativeDependenciesChange(std::vector<UnistyleDe
         }
 
         // check if color scheme changed and then if Unistyles state depend on it (adaptive themes)
-        auto colorSchemeIt = std::find(dependencies.begin(), dependencies.end(), UnistyleDependency::COLORSCHEME);
-        auto hasNewColorScheme = colorSchemeIt != dependencies.end();
+        auto hasNewColorScheme = nativeDependencyMask.contains(UnistyleDependency::COLORSCHEME);
 
         if (hasNewColorScheme) {
             this->_unistylesRuntime->includeDependenciesForColorSchemeChange(unistyleDependencies);
         }
 
-        auto dependencyMap = registry.buildDependencyMap(rt, unistyleDependencies);
+        auto dependencyMask = helpers::DependencyMask(unistyleDependencies);
+        auto dependencyMap = registry.buildDependencyMap(rt, dependencyMask);
 
         if (dependencyMap.empty()) {
             this->notifyJSListeners(unistyleDependencies);
@@ -339,7 +380,7 @@ void HybridStyleSheet::onPlatformNativeDependenciesChange(std::vector<UnistyleDe
         // in a later step, we will rebuild only Unistyles with mounted StyleSheets
         // however, user may have StyleSheets with components that haven't mounted yet
         // we need to rebuild all dependent StyleSheets as well
-        auto dependentStyleSheets = registry.getStyleSheetsToRefresh(rt, unistyleDependencies);
+        auto dependentStyleSheets = registry.getStyleSheetsToRefresh(rt, dependencyMask);
 
         parser.rebuildUnistylesInDependencyMap(rt, dependencyMap, dependentStyleSheets, miniRuntime);
 
@@ -349,10 +390,9 @@ void HybridStyleSheet::onPlatformNativeDependenciesChange(std::vector<UnistyleDe
             return;
         }
 
-        parser.rebuildShadowLeafUpdates(rt, dependencyMap);
+        parser.rebuildShadowLeafUpdates(rt, dependencyMap, shadow::getShadowLane(dependencyMask));
 
-        this->notifyJSListeners(unistyleDependencies);
-        shadow::ShadowTreeManager::updateShadowTree(rt);
+        this->scheduleShadowTreeUpdate(rt, unistyleDependencies);
     });
 }
 
@@ -365,7 +405,7 @@ void HybridStyleSheet::onImeChange(UnistylesNativeMiniRuntime miniRuntime) {
         std::vector<UnistyleDependency> dependencies{UnistyleDependency::IME};
         auto& registry = core::UnistylesRegistry::get();
         auto parser = parser::Parser(this->_unistylesRuntime);
-        auto dependencyMap = registry.buildDependencyMap(rt, dependencies);
+        auto dependencyMap = registry.buildDependencyMap(rt, helpers::DependencyMask(UnistyleDependency::IME));
 
         if (dependencyMap.empty()) {
             this->notifyJSListeners(dependencies);
@@ -378,10 +418,23 @@ void HybridStyleSheet::onImeChange(UnistylesNativeMiniRuntime miniRuntime) {
         std::vector<std::shared_ptr<core::StyleSheet>> dependentStyleSheets;
 
         parser.rebuildUnistylesInDependencyMap(rt, dependencyMap, dependentStyleSheets, miniRuntime);
-        parser.rebuildShadowLeafUpdates(rt, dependencyMap);
+        parser.rebuildShadowLeafUpdates(rt, dependencyMap, shadow::ShadowLane::URGENT);
 
-        this->notifyJSListeners(dependencies);
-        shadow::ShadowTreeManager::updateShadowTree(rt);
+        this->scheduleShadowTreeUpdate(rt, dependencies);
+    });
+}
+
+void HybridStyleSheet::scheduleShadowTreeUpdate(jsi::Runtime& rt, std::vector<UnistyleDependency>& dependencies) {
+    // JS listeners are notified once updates queued so far land, so they never see styles that are not committed yet
+    // listener can outlive StyleSheet, eg. when runtime is reloaded
+    std::weak_ptr<HybridObject> weakStyleSheet = this->weak_from_this();
+
+    shadow::ShadowTreeManager::scheduleShadowTreeUpdate(rt, [weakStyleSheet, dependencies]() mutable {
+        auto styleSheet = std::dynamic_pointer_cast<HybridStyleSheet>(weakStyleSheet.lock());
+
+        if (styleSheet != nullptr) {
+            styleSheet->notifyJSListeners(dependencies);
+        }
     });
 }
 
@@ -10,6 +10,7 @@
 #include "Breakpoints.h"
 #include "Parser.h"
 #include "ShadowTreeManager.h"
+#include "UnistylesCommitHook.h"
 
 using namespace margelo::nitro::unistyles;
 using namespace facebook::react;
@@ -43,6 +44,14 @@ struct HybridStyleSheet: public HybridUnistylesStyleSheetSpec {
                       const jsi::Value& thisValue,
                       const jsi::Value* args,
                       size_t count);
+    jsi::Value release(jsi::Runtime& rt,
+                      const jsi::Value& thisValue,
+                      const jsi::Value* args,
+                      size_t count);
+    jsi::Value getRegistryStats(jsi::Runtime& rt,
+                      const jsi::Value& thisValue,
+                      const jsi::Value* args,
+                      size_t count);
 
     void loadHybridMethods() override {
         HybridUnistylesStyleSheetSpec::loadHybridMethods();
@@ -51,6 +60,8 @@ struct HybridStyleSheet: public HybridUnistylesStyleSheetSpec {
             prototype.registerRawHybridMethod("init", 1, &HybridStyleSheet::init);
             prototype.registerRawHybridMethod("create", 1, &HybridStyleSheet::create);
             prototype.registerRawHybridMethod("configure", 1, &HybridStyleSheet::configure);
+            prototype.registerRawHybridMethod("release", 1, &HybridStyleSheet::release);
+            prototype.registerRawHybridMethod("getRegistryStats", 0, &HybridStyleSheet::getRegistryStats);
         });
     };
 
@@ -68,12 +79,12 @@ private:
     void onPlatformDependenciesChange(std::vector<UnistyleDependency> dependencies);
     void onPlatformNativeDependenciesChange(std::vector<UnistyleDependency> dependencies, UnistylesNativeMiniRuntime miniRuntime);
     void onImeChange(UnistylesNativeMiniRuntime miniRuntime);
+    void scheduleShadowTreeUpdate(jsi::Runtime& rt, std::vector<UnistyleDependency>& dependencies);
     void notifyJSListeners(std::vector<UnistyleDependency>& dependencies);
 
     bool isInitialized = false;
     double __unid = -1;
     std::vector<std::unique_ptr<const std::function<void(std::vector<UnistyleDependency>&)>>> _changeListeners{};
     std::shared_ptr<HybridUnistylesRuntime> _unistylesRuntime;
-    std::shared_ptr<UIManager> _uiManager;
 };
 
@@ -74,10 +74,10 @@ double HybridUnistylesRuntime::getFontScale() {
 
 std::unordered_map<std::string, double> HybridUnistylesRuntime::getBreakpoints() {
     auto& state = core::UnistylesRegistry::get().getState(*_rt);
-    auto sortedBreakpointPairs = state.getSortedBreakpointPairs();
+    auto& sortedBreakpointPairs = state.getSortedBreakpointPairs();
     std::unordered_map<std::string, double> breakpoints{};
 
-    std::for_each(sortedBreakpointPairs.begin(), sortedBreakpointPairs.end(), [&breakpoints](std::pair<std::string, double>& pair){
+    std::for_each(sortedBreakpointPairs.begin(), sortedBreakpointPairs.end(), [&breakpoints](const std::pair<std::string, double>& pair){
         breakpoints[pair.first] = pair.second;
     });
 
@@ -0,0 +1,315 @@
+#include "BoxShadowParser.h"
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+using namespace margelo::nitro::unistyles;
+
+namespace {
+
+inline bool isWhitespace(char character) {
+    return character == ' ' || character == '\t' || character == '\n' || character == '\r' || character == '\f' || character == '\v';
+}
+
+inline bool isDigit(char character) {
+    return character >= '0' && character <= '9';
+}
+
+std::string_view trim(std::string_view str) {
+    while (!str.empty() && isWhitespace(str.front())) {
+        str.remove_prefix(1);
+    }
+
+    while (!str.empty() && isWhitespace(str.back())) {
+        str.remove_suffix(1);
+    }
+
+    return str;
+}
+
+// for every index tells if the closest parenthesis on the right is ')', which means we're inside of ()
+std::vector<bool> getInsideParenthesesMap(std::string_view str) {
+    std::vector<bool> insideParentheses(str.size() + 1, false);
+    bool isInside = false;
+
+    for (size_t i = str.size(); i > 0; i--) {
+        auto character = str[i - 1];
+
+        if (character == ')') {
+            isInside = true;
+        }
+
+        if (character == '(') {
+            isInside = false;
+        }
+
+        insideParentheses[i - 1] = isInside;
+    }
+
+    return insideParentheses;
+}
+
+// equivalent of str.split(/,(?![^()]*\))/)
+std::vector<std::string_view> splitByComma(std::string_view str) {
+    std::vector<std::string_view> parts{};
+    auto insideParentheses = getInsideParenthesesMap(str);
+    size_t partStart = 0;
+
+    for (size_t i = 0; i < str.size(); i++) {
+        if (str[i] == ',' && !insideParentheses[i + 1]) {
+            parts.emplace_back(str.substr(partStart, i - partStart));
+            partStart = i + 1;
+        }
+    }
+
+    parts.emplace_back(str.substr(partStart));
+
+    return parts;
+}
+
+// equivalent of str.split(/\s+(?![^(]*\))/)
+std::vector<std::string_view> splitByWhitespace(std::string_view str) {
+    std::vector<std::string_view> parts{};
+    auto insideParentheses = getInsideParenthesesMap(str);
+    size_t partStart = 0;
+    size_t i = 0;
+
+    while (i < str.size()) {
+        if (!isWhitespace(str[i])) {
+            i++;
+
+            continue;
+        }
+
+        auto whitespaceEnd = i;
+
+        while (whitespaceEnd < str.size() && isWhitespace(str[whitespaceEnd])) {
+            whitespaceEnd++;
+        }
+
+        if (!insideParentheses[whitespaceEnd]) {
+            parts.emplace_back(str.substr(partStart, i - partStart));
+            partStart = whitespaceEnd;
+        }
+
+        i = whitespaceEnd;
+    }
+
+    parts.emplace_back(str.substr(partStart));
+
+    return parts;
+}
+
+// Number.parseFloat, parses the longest valid prefix or returns NaN
+double parseFloat(std::string_view str) {
+    size_t position = 0;
+
+    while (position < str.size() && isWhitespace(str[position])) {
+        position++;
+    }
+
+    auto start = position;
+    auto isNegative = false;
+
+    if (position < str.size() && (str[position] == '+' || str[position] == '-')) {
+        isNegative = str[position] == '-';
+        position++;
+    }
+
+    if (str.substr(position).starts_with("Infinity")) {
+        return isNegative
+            ? -std::numeric_limits<double>::infinity()
+            : std::numeric_limits<double>::infinity();
+    }
+
+    auto digitsStart = position;
+
+    while (position < str.size() && isDigit(str[position])) {
+        position++;
+    }
+
+    auto hasIntegerPart = position > digitsStart;
+    auto hasFractionPart = false;
+
+    if (position < str.size() && str[position] == '.') {
+        auto fractionStart = position + 1;
+        auto fractionEnd = fractionStart;
+
+        while (fractionEnd < str.size() && isDigit(str[fractionEnd])) {
+            fractionEnd++;
+        }
+
+        hasFractionPart = fractionEnd > fractionStart;
+
+        // "5." is valid, "." is not
+        if (hasIntegerPart || hasFractionPart) {
+            position = fractionEnd;
+        }
+    }
+
+    if (!hasIntegerPart && !hasFractionPart) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    if (position < str.size() && (str[position] == 'e' || str[position] == 'E')) {
+        auto exponentPosition = position + 1;
+
+        if (exponentPosition < str.size() && (str[exponentPosition] == '+' || str[exponentPosition] == '-')) {
+            exponentPosition++;
+        }
+
+        auto exponentDigitsStart = exponentPosition;
+
+        while (exponentPosition < str.size() && isDigit(str[exponentPosition])) {
+            exponentPosition++;
+        }
+
+        if (exponentPosition > exponentDigitsStart) {
+            position = exponentPosition;
+        }
+    }
+
+    // prefix is already validated, so strtod can't consume anything else (eg. hex or nan)
+    auto number = std::string(str.substr(start, position - start));
+
+    return std::strtod(number.c_str(), nullptr);
+}
+
+inline bool isValue(std::optional<std::string_view> str) {
+    return str.has_value() && !str->empty() && (str.value() == "0" || str->ends_with("px"));
+}
+
+}
+
+std::vector<parser::BoxShadow> parser::BoxShadowParser::parse(std::string_view boxShadowString, const ColorValidator& isValidColor) {
+    std::vector<BoxShadow> boxShadows{};
+
+    for (auto part : splitByComma(boxShadowString)) {
+        auto boxShadow = std::string(trim(part));
+        auto newLinePosition = boxShadow.find('\n');
+
+        // mimics JS String.replace, which replaces only the first occurrence
+        if (newLinePosition != std::string::npos) {
+            boxShadow.erase(newLinePosition, 1);
+        }
+
+        if (boxShadow.empty()) {
+            continue;
+        }
+
+        auto parsedBoxShadow = parseBoxShadow(boxShadow, isValidColor);
+
+        if (parsedBoxShadow.has_value()) {
+            boxShadows.emplace_back(std::move(parsedBoxShadow.value()));
+        }
+    }
+
+    return boxShadows;
+}
+
+std::optional<parser::BoxShadow> parser::BoxShadowParser::parseBoxShadow(std::string_view boxShadow, const ColorValidator& isValidColor) {
+    if (boxShadow == "none") {
+        return std::nullopt;
+    }
+
+    auto parts = splitByWhitespace(boxShadow);
+    int lastIndex = static_cast<int>(parts.size()) - 1;
+    int insetIndex = -1;
+
+    for (int i = 0; i <= lastIndex; i++) {
+        if (parts[i] == "inset") {
+            insetIndex = i;
+
+            break;
+        }
+    }
+
+    // inset can only be at the start or end
+    if (insetIndex != -1 && insetIndex != 0 && insetIndex != lastIndex) {
+        return std::nullopt;
+    }
+
+    auto partAt = [&parts](int index) -> std::optional<std::string_view> {
+        if (index < 0 || index >= static_cast<int>(parts.size())) {
+            return std::nullopt;
+        }
+
+        return parts[index];
+    };
+
+    // if there is no inset, color can only be at the start or end
+    std::array<int, 2> maybeColorsIndexes = insetIndex == -1
+        ? std::array<int, 2>{0, lastIndex}
+        : insetIndex == lastIndex
+            ? std::array<int, 2>{0, lastIndex - 1}
+            : std::array<int, 2>{1, lastIndex};
+    int colorIndex = -1;
+
+    for (auto index : maybeColorsIndexes) {
+        if (!isValue(partAt(index))) {
+            colorIndex = index;
+
+            break;
+        }
+    }
+
+    BoxShadow result{};
+    auto maybeColor = partAt(colorIndex);
+
+    if (maybeColor.has_value() && !maybeColor->empty()) {
+        auto color = std::string(maybeColor.value());
+
+        if (isValidColor(color)) {
+            result.color = std::move(color);
+        }
+    }
+
+    // invalid color is still excluded from values
+    std::vector<std::string_view> values{};
+
+    for (int i = 0; i <= lastIndex; i++) {
+        if (i != colorIndex && i != insetIndex) {
+            values.emplace_back(parts[i]);
+        }
+    }
+
+    // at this point there can be only 4 values
+    if (values.size() > 4) {
+        return std::nullopt;
+    }
+
+    auto valueAt = [&values](size_t index) -> std::optional<std::string_view> {
+        if (index >= values.size()) {
+            return std::nullopt;
+        }
+
+        return values[index];
+    };
+
+    auto offsetX = valueAt(0);
+    auto offsetY = valueAt(1);
+    auto blurRadius = valueAt(2);
+    auto spreadRadius = valueAt(3);
+
+    if (!isValue(offsetX) || !isValue(offsetY)) {
+        return std::nullopt;
+    }
+
+    if (isValue(blurRadius)) {
+        result.blurRadius = parseFloat(blurRadius.value());
+
+        if (result.blurRadius < 0) {
+            return std::nullopt;
+        }
+    }
+
+    result.inset = insetIndex != -1;
+    result.offsetX = parseFloat(offsetX.value());
+    result.offsetY = parseFloat(offsetY.value());
+    result.spreadDistance = spreadRadius.has_value() && !spreadRadius->empty()
+        ? parseFloat(spreadRadius.value())
+        : 0;
+
+    return result;
+}
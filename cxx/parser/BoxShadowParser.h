@@ -0,0 +1,31 @@
+#pragma once
+
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace margelo::nitro::unistyles::parser {
+
+struct BoxShadow {
+    bool inset = false;
+    double offsetX = 0;
+    double offsetY = 0;
+    double blurRadius = 0;
+    double spreadDistance = 0;
+    std::optional<std::string> color = std::nullopt;
+};
+
+// C++ port of boxShadow string grammar, eg. "inset 0 5px 10px red, 1px 1px rgba(0, 0, 0, 0.5)"
+// invalid shadows are skipped, same as in React Native
+struct BoxShadowParser {
+    using ColorValidator = std::function<bool(const std::string& color)>;
+
+    static std::vector<BoxShadow> parse(std::string_view boxShadowString, const ColorValidator& isValidColor);
+
+private:
+    static std::optional<BoxShadow> parseBoxShadow(std::string_view boxShadow, const ColorValidator& isValidColor);
+};
+
+}
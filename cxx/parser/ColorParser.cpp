@@ -0,0 +1,708 @@
+#include "ColorParser.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+
+// results must match JS implementation bit by bit, so we can't allow fused multiply-add
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#endif
+
+using namespace margelo::nitro::unistyles;
+
+namespace {
+
+using NamedColor = std::pair<std::string_view, uint32_t>;
+
+// must stay sorted, it's binary searched
+constexpr std::array<NamedColor, 150> namedColors{{
+    {"aliceblue", 0xf0f8ffff},
+    {"antiquewhite", 0xfaebd7ff},
+    {"aqua", 0x00ffffff},
+    {"aquamarine", 0x7fffd4ff},
+    {"azure", 0xf0ffffff},
+    {"beige", 0xf5f5dcff},
+    {"bisque", 0xffe4c4ff},
+    {"black", 0x000000ff},
+    {"blanchedalmond", 0xffebcdff},
+    {"blue", 0x0000ffff},
+    {"blueviolet", 0x8a2be2ff},
+    {"brown", 0xa52a2aff},
+    {"burlywood", 0xdeb887ff},
+    {"burntsienna", 0xea7e5dff},
+    {"cadetblue", 0x5f9ea0ff},
+    {"chartreuse", 0x7fff00ff},
+    {"chocolate", 0xd2691eff},
+    {"coral", 0xff7f50ff},
+    {"cornflowerblue", 0x6495edff},
+    {"cornsilk", 0xfff8dcff},
+    {"crimson", 0xdc143cff},
+    {"cyan", 0x00ffffff},
+    {"darkblue", 0x00008bff},
+    {"darkcyan", 0x008b8bff},
+    {"darkgoldenrod", 0xb8860bff},
+    {"darkgray", 0xa9a9a9ff},
+    {"darkgreen", 0x006400ff},
+    {"darkgrey", 0xa9a9a9ff},
+    {"darkkhaki", 0xbdb76bff},
+    {"darkmagenta", 0x8b008bff},
+    {"darkolivegreen", 0x556b2fff},
+    {"darkorange", 0xff8c00ff},
+    {"darkorchid", 0x9932ccff},
+    {"darkred", 0x8b0000ff},
+    {"darksalmon", 0xe9967aff},
+    {"darkseagreen", 0x8fbc8fff},
+    {"darkslateblue", 0x483d8bff},
+    {"darkslategray", 0x2f4f4fff},
+    {"darkslategrey", 0x2f4f4fff},
+    {"darkturquoise", 0x00ced1ff},
+    {"darkviolet", 0x9400d3ff},
+    {"deeppink", 0xff1493ff},
+    {"deepskyblue", 0x00bfffff},
+    {"dimgray", 0x696969ff},
+    {"dimgrey", 0x696969ff},
+    {"dodgerblue", 0x1e90ffff},
+    {"firebrick", 0xb22222ff},
+    {"floralwhite", 0xfffaf0ff},
+    {"forestgreen", 0x228b22ff},
+    {"fuchsia", 0xff00ffff},
+    {"gainsboro", 0xdcdcdcff},
+    {"ghostwhite", 0xf8f8ffff},
+    {"gold", 0xffd700ff},
+    {"goldenrod", 0xdaa520ff},
+    {"gray", 0x808080ff},
+    {"green", 0x008000ff},
+    {"greenyellow", 0xadff2fff},
+    {"grey", 0x808080ff},
+    {"honeydew", 0xf0fff0ff},
+    {"hotpink", 0xff69b4ff},
+    {"indianred", 0xcd5c5cff},
+    {"indigo", 0x4b0082ff},
+    {"ivory", 0xfffff0ff},
+    {"khaki", 0xf0e68cff},
+    {"lavender", 0xe6e6faff},
+    {"lavenderblush", 0xfff0f5ff},
+    {"lawngreen", 0x7cfc00ff},
+    {"lemonchiffon", 0xfffacdff},
+    {"lightblue", 0xadd8e6ff},
+    {"lightcoral", 0xf08080ff},
+    {"lightcyan", 0xe0ffffff},
+    {"lightgoldenrodyellow", 0xfafad2ff},
+    {"lightgray", 0xd3d3d3ff},
+    {"lightgreen", 0x90ee90ff},
+    {"lightgrey", 0xd3d3d3ff},
+    {"lightpink", 0xffb6c1ff},
+    {"lightsalmon", 0xffa07aff},
+    {"lightseagreen", 0x20b2aaff},
+    {"lightskyblue", 0x87cefaff},
+    {"lightslategray", 0x778899ff},
+    {"lightslategrey", 0x778899ff},
+    {"lightsteelblue", 0xb0c4deff},
+    {"lightyellow", 0xffffe0ff},
+    {"lime", 0x00ff00ff},
+    {"limegreen", 0x32cd32ff},
+    {"linen", 0xfaf0e6ff},
+    {"magenta", 0xff00ffff},
+    {"maroon", 0x800000ff},
+    {"mediumaquamarine", 0x66cdaaff},
+    {"mediumblue", 0x0000cdff},
+    {"mediumorchid", 0xba55d3ff},
+    {"mediumpurple", 0x9370dbff},
+    {"mediumseagreen", 0x3cb371ff},
+    {"mediumslateblue", 0x7b68eeff},
+    {"mediumspringgreen", 0x00fa9aff},
+    {"mediumturquoise", 0x48d1ccff},
+    {"mediumvioletred", 0xc71585ff},
+    {"midnightblue", 0x191970ff},
+    {"mintcream", 0xf5fffaff},
+    {"mistyrose", 0xffe4e1ff},
+    {"moccasin", 0xffe4b5ff},
+    {"navajowhite", 0xffdeadff},
+    {"navy", 0x000080ff},
+    {"oldlace", 0xfdf5e6ff},
+    {"olive", 0x808000ff},
+    {"olivedrab", 0x6b8e23ff},
+    {"orange", 0xffa500ff},
+    {"orangered", 0xff4500ff},
+    {"orchid", 0xda70d6ff},
+    {"palegoldenrod", 0xeee8aaff},
+    {"palegreen", 0x98fb98ff},
+    {"paleturquoise", 0xafeeeeff},
+    {"palevioletred", 0xdb7093ff},
+    {"papayawhip", 0xffefd5ff},
+    {"peachpuff", 0xffdab9ff},
+    {"peru", 0xcd853fff},
+    {"pink", 0xffc0cbff},
+    {"plum", 0xdda0ddff},
+    {"powderblue", 0xb0e0e6ff},
+    {"purple", 0x800080ff},
+    {"rebeccapurple", 0x663399ff},
+    {"red", 0xff0000ff},
+    {"rosybrown", 0xbc8f8fff},
+    {"royalblue", 0x4169e1ff},
+    {"saddlebrown", 0x8b4513ff},
+    {"salmon", 0xfa8072ff},
+    {"sandybrown", 0xf4a460ff},
+    {"seagreen", 0x2e8b57ff},
+    {"seashell", 0xfff5eeff},
+    {"sienna", 0xa0522dff},
+    {"silver", 0xc0c0c0ff},
+    {"skyblue", 0x87ceebff},
+    {"slateblue", 0x6a5acdff},
+    {"slategray", 0x708090ff},
+    {"slategrey", 0x708090ff},
+    {"snow", 0xfffafaff},
+    {"springgreen", 0x00ff7fff},
+    {"steelblue", 0x4682b4ff},
+    {"tan", 0xd2b48cff},
+    {"teal", 0x008080ff},
+    {"thistle", 0xd8bfd8ff},
+    {"tomato", 0xff6347ff},
+    {"transparent", 0x00000000},
+    {"turquoise", 0x40e0d0ff},
+    {"violet", 0xee82eeff},
+    {"wheat", 0xf5deb3ff},
+    {"white", 0xffffffff},
+    {"whitesmoke", 0xf5f5f5ff},
+    {"yellow", 0xffff00ff},
+    {"yellowgreen", 0x9acd32ff},
+}};
+
+static_assert(std::is_sorted(namedColors.begin(), namedColors.end(), [](const NamedColor& a, const NamedColor& b){
+    return a.first < b.first;
+}), "Unistyles: named colors must be sorted.");
+
+constexpr uint64_t SWAR_ONES = 0x0101010101010101ULL;
+constexpr uint64_t SWAR_HIGH = 0x8080808080808080ULL;
+
+// sets high bit of every byte that is in [lo, hi], all bytes must be ASCII
+constexpr uint64_t bytesInRange(uint64_t chunk, uint8_t lo, uint8_t hi) {
+    auto greaterOrEqual = chunk + SWAR_ONES * (0x80 - lo);
+    auto lessOrEqual = SWAR_ONES * (0x80 + hi) - chunk;
+
+    return greaterOrEqual & lessOrEqual & SWAR_HIGH;
+}
+
+// validates and decodes 8 hex digits at once, first digit is the most significant one
+inline std::optional<uint32_t> decodeHex8(const char* digits) {
+    uint64_t chunk = 0;
+
+    // compilers turn it into a single load on little endian
+    for (size_t i = 0; i < 8; i++) {
+        chunk |= static_cast<uint64_t>(static_cast<uint8_t>(digits[i])) << (i * 8);
+    }
+
+    if ((chunk & SWAR_HIGH) != 0) {
+        return std::nullopt;
+    }
+
+    auto validBytes = bytesInRange(chunk, '0', '9') | bytesInRange(chunk, 'a', 'f') | bytesInRange(chunk, 'A', 'F');
+
+    if (validBytes != SWAR_HIGH) {
+        return std::nullopt;
+    }
+
+    // '0'-'9' -> 0-9, letters have 7th bit set and need extra 9
+    auto letters = (chunk >> 6) & SWAR_ONES;
+    auto nibbles = (chunk & (SWAR_ONES * 0x0F)) + letters * 9;
+
+    // every even byte holds one decoded byte
+    auto bytes = ((nibbles << 4) | (nibbles >> 8)) & 0x00FF00FF00FF00FFULL;
+
+    return static_cast<uint32_t>(
+        ((bytes & 0xFF) << 24) |
+        (((bytes >> 16) & 0xFF) << 16) |
+        (((bytes >> 32) & 0xFF) << 8) |
+        ((bytes >> 48) & 0xFF)
+    );
+}
+
+inline bool isWhitespace(char character) {
+    return character == ' ' || character == '\t' || character == '\n' || character == '\r' || character == '\f' || character == '\v';
+}
+
+// Math.round
+inline double jsRound(double value) {
+    auto floored = std::floor(value);
+
+    return value - floored >= 0.5 ? floored + 1 : floored;
+}
+
+inline uint32_t toByte(double value) {
+    return static_cast<uint32_t>(static_cast<int32_t>(value)) & 0xFF;
+}
+
+// NUMBER token validated by CallParser: [-+]?\d*\.?\d+
+struct NumberToken {
+    bool negative = false;
+    std::string_view integer;
+    std::string_view fraction;
+
+    // parseInt, std::nullopt represents NaN
+    std::optional<double> toInt() const {
+        if (this->integer.empty()) {
+            return std::nullopt;
+        }
+
+        double value = 0;
+
+        for (char digit : this->integer) {
+            value = value * 10 + (digit - '0');
+        }
+
+        return this->negative ? -value : value;
+    }
+
+    // parseFloat, exact as long as there are less than 16 digits (enforced by CallParser)
+    double toFloat() const {
+        double mantissa = 0;
+        double divider = 1;
+
+        for (char digit : this->integer) {
+            mantissa = mantissa * 10 + (digit - '0');
+        }
+
+        for (char digit : this->fraction) {
+            mantissa = mantissa * 10 + (digit - '0');
+            divider *= 10;
+        }
+
+        auto value = mantissa / divider;
+
+        return this->negative ? -value : value;
+    }
+};
+
+// strict equivalent of RN regexes, returns false for anything that is ambiguous
+struct CallParser {
+    enum class Separator {
+        Optional,
+        Comma,
+        Slash
+    };
+
+    explicit CallParser(std::string_view input): input{input} {}
+
+    // function name must be directly followed by '('
+    bool open() {
+        if (!this->consume('(')) {
+            return false;
+        }
+
+        this->skipWhitespace();
+
+        return true;
+    }
+
+    bool close() {
+        this->skipWhitespace();
+
+        return this->consume(')') && this->position == this->input.size();
+    }
+
+    bool separator(Separator separator) {
+        this->skipWhitespace();
+
+        switch (separator) {
+            case Separator::Optional:
+                this->consume(',');
+
+                break;
+            case Separator::Comma:
+                if (!this->consume(',')) {
+                    return false;
+                }
+
+                break;
+            case Separator::Slash:
+                if (!this->consume('/')) {
+                    return false;
+                }
+
+                break;
+        }
+
+        this->skipWhitespace();
+
+        return true;
+    }
+
+    std::optional<NumberToken> number() {
+        NumberToken token{};
+
+        if (this->position < this->input.size() && (this->input[this->position] == '-' || this->input[this->position] == '+')) {
+            token.negative = this->input[this->position] == '-';
+            this->position++;
+        }
+
+        token.integer = this->digits();
+
+        if (this->position < this->input.size() && this->input[this->position] == '.') {
+            this->position++;
+            token.fraction = this->digits();
+
+            if (token.fraction.empty()) {
+                return std::nullopt;
+            }
+        }
+
+        if (token.integer.empty() && token.fraction.empty()) {
+            return std::nullopt;
+        }
+
+        if (token.integer.size() + token.fraction.size() > 15) {
+            return std::nullopt;
+        }
+
+        return token;
+    }
+
+    std::optional<NumberToken> percentage() {
+        auto token = this->number();
+
+        if (!token.has_value() || !this->consume('%')) {
+            return std::nullopt;
+        }
+
+        return token;
+    }
+
+    // returns true if all arguments after current position are separated by commas
+    bool hasCommaSeparatedArguments(size_t count) {
+        size_t commas = 0;
+
+        for (size_t i = this->position; i < this->input.size(); i++) {
+            if (this->input[i] == ',') {
+                commas++;
+            }
+        }
+
+        return commas == count - 1;
+    }
+
+private:
+    void skipWhitespace() {
+        while (this->position < this->input.size() && isWhitespace(this->input[this->position])) {
+            this->position++;
+        }
+    }
+
+    bool consume(char character) {
+        if (this->position < this->input.size() && this->input[this->position] == character) {
+            this->position++;
+
+            return true;
+        }
+
+        return false;
+    }
+
+    std::string_view digits() {
+        auto start = this->position;
+
+        while (this->position < this->input.size() && this->input[this->position] >= '0' && this->input[this->position] <= '9') {
+            this->position++;
+        }
+
+        return this->input.substr(start, this->position - start);
+    }
+
+    std::string_view input;
+    size_t position = 0;
+};
+
+inline uint32_t parse255(const NumberToken& token) {
+    auto value = token.toInt();
+
+    // NaN << 24 === 0
+    if (!value.has_value() || value.value() < 0) {
+        return 0;
+    }
+
+    if (value.value() > 255) {
+        return 255;
+    }
+
+    return static_cast<uint32_t>(value.value());
+}
+
+inline uint32_t parse1(const NumberToken& token) {
+    auto value = token.toFloat();
+
+    if (value < 0) {
+        return 0;
+    }
+
+    if (value > 1) {
+        return 255;
+    }
+
+    return toByte(jsRound(value * 255));
+}
+
+inline double parse360(const NumberToken& token) {
+    auto value = token.toFloat();
+
+    return std::fmod(std::fmod(value, 360) + 360, 360) / 360;
+}
+
+inline double parsePercentage(const NumberToken& token) {
+    auto value = token.toFloat();
+
+    if (value < 0) {
+        return 0;
+    }
+
+    if (value > 100) {
+        return 1;
+    }
+
+    return value / 100;
+}
+
+inline double hueToRgb(double p, double q, double t) {
+    if (t < 0) {
+        t += 1;
+    }
+
+    if (t > 1) {
+        t -= 1;
+    }
+
+    if (t < 1.0 / 6) {
+        return p + (q - p) * 6 * t;
+    }
+
+    if (t < 1.0 / 2) {
+        return q;
+    }
+
+    if (t < 2.0 / 3) {
+        return p + (q - p) * (2.0 / 3 - t) * 6;
+    }
+
+    return p;
+}
+
+inline uint32_t packRgb(double red, double green, double blue) {
+    return (toByte(jsRound(red * 255)) << 24) | (toByte(jsRound(green * 255)) << 16) | (toByte(jsRound(blue * 255)) << 8);
+}
+
+inline uint32_t hslToRgb(double h, double s, double l) {
+    auto q = l < 0.5 ? l * (1 + s) : l + s - l * s;
+    auto p = 2 * l - q;
+
+    return packRgb(hueToRgb(p, q, h + 1.0 / 3), hueToRgb(p, q, h), hueToRgb(p, q, h - 1.0 / 3));
+}
+
+inline uint32_t hwbToRgb(double h, double w, double b) {
+    if (w + b >= 1) {
+        auto gray = toByte(jsRound((w * 255) / (w + b)));
+
+        return (gray << 24) | (gray << 16) | (gray << 8);
+    }
+
+    auto red = hueToRgb(0, 1, h + 1.0 / 3) * (1 - w - b) + w;
+    auto green = hueToRgb(0, 1, h) * (1 - w - b) + w;
+    auto blue = hueToRgb(0, 1, h - 1.0 / 3) * (1 - w - b) + w;
+
+    return packRgb(red, green, blue);
+}
+
+// parses "(a, b, c)" or "(a b c / d)" with given argument parsers
+template<typename First, typename Rest>
+inline std::optional<std::array<NumberToken, 4>> parseArguments(CallParser& parser, size_t count, CallParser::Separator separator, First&& first, Rest&& rest) {
+    std::array<NumberToken, 4> arguments{};
+
+    if (!parser.open()) {
+        return std::nullopt;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (i > 0) {
+            auto isAlpha = i == 3;
+            auto currentSeparator = isAlpha && separator == CallParser::Separator::Slash
+                ? CallParser::Separator::Slash
+                : separator == CallParser::Separator::Comma
+                    ? CallParser::Separator::Comma
+                    : CallParser::Separator::Optional;
+
+            if (!parser.separator(currentSeparator)) {
+                return std::nullopt;
+            }
+        }
+
+        auto token = i == 0 || i == 3
+            ? first()
+            : rest();
+
+        if (!token.has_value()) {
+            return std::nullopt;
+        }
+
+        arguments[i] = token.value();
+    }
+
+    if (!parser.close()) {
+        return std::nullopt;
+    }
+
+    return arguments;
+}
+
+}
+
+std::optional<uint32_t> parser::ColorParser::normalizeColor(std::string_view color) {
+    if (color.empty()) {
+        return std::nullopt;
+    }
+
+    if (color[0] == '#') {
+        return parseHex(color);
+    }
+
+    if (color.starts_with("rgb")) {
+        return parseRgb(color);
+    }
+
+    if (color.starts_with("hsl")) {
+        return parseHsl(color);
+    }
+
+    if (color.starts_with("hwb")) {
+        return parseHwb(color);
+    }
+
+    return parseNamedColor(color);
+}
+
+std::optional<uint32_t> parser::ColorParser::processColor(std::string_view color) {
+    auto normalizedColor = normalizeColor(color);
+
+    if (!normalizedColor.has_value()) {
+        return std::nullopt;
+    }
+
+    // 0xRRGGBBAA -> 0xAARRGGBB
+    auto rgba = normalizedColor.value();
+
+    return (rgba << 24) | (rgba >> 8);
+}
+
+std::optional<uint32_t> parser::ColorParser::parseHex(std::string_view color) {
+    auto digits = color.substr(1);
+    char expanded[8] = {'f', 'f', 'f', 'f', 'f', 'f', 'f', 'f'};
+
+    switch (digits.size()) {
+        // #rgb, #rgba
+        case 3:
+        case 4:
+            for (size_t i = 0; i < digits.size(); i++) {
+                expanded[i * 2] = digits[i];
+                expanded[i * 2 + 1] = digits[i];
+            }
+
+            return decodeHex8(expanded);
+        // #rrggbb
+        case 6:
+            std::copy(digits.begin(), digits.end(), expanded);
+
+            return decodeHex8(expanded);
+        // #rrggbbaa
+        case 8:
+            return decodeHex8(digits.data());
+        default:
+            return std::nullopt;
+    }
+}
+
+std::optional<uint32_t> parser::ColorParser::parseNamedColor(std::string_view color) {
+    auto it = std::lower_bound(namedColors.begin(), namedColors.end(), color, [](const NamedColor& namedColor, std::string_view name){
+        return namedColor.first < name;
+    });
+
+    if (it == namedColors.end() || it->first != color) {
+        return std::nullopt;
+    }
+
+    return it->second;
+}
+
+std::optional<uint32_t> parser::ColorParser::parseRgb(std::string_view color) {
+    auto isRgba = color.starts_with("rgba");
+    CallParser parser(color.substr(isRgba ? 4 : 3));
+    auto number = [&parser](){ return parser.number(); };
+
+    if (!isRgba) {
+        auto arguments = parseArguments(parser, 3, CallParser::Separator::Optional, number, number);
+
+        if (!arguments.has_value()) {
+            return std::nullopt;
+        }
+
+        auto& [red, green, blue, _] = arguments.value();
+
+        return (parse255(red) << 24) | (parse255(green) << 16) | (parse255(blue) << 8) | 0x000000ff;
+    }
+
+    auto separator = parser.hasCommaSeparatedArguments(4)
+        ? CallParser::Separator::Comma
+        : CallParser::Separator::Slash;
+    auto arguments = parseArguments(parser, 4, separator, number, number);
+
+    if (!arguments.has_value()) {
+        return std::nullopt;
+    }
+
+    auto& [red, green, blue, alpha] = arguments.value();
+
+    return (parse255(red) << 24) | (parse255(green) << 16) | (parse255(blue) << 8) | parse1(alpha);
+}
+
+std::optional<uint32_t> parser::ColorParser::parseHsl(std::string_view color) {
+    auto isHsla = color.starts_with("hsla");
+    CallParser parser(color.substr(isHsla ? 4 : 3));
+    auto number = [&parser](){ return parser.number(); };
+    auto percentage = [&parser](){ return parser.percentage(); };
+
+    if (!isHsla) {
+        auto arguments = parseArguments(parser, 3, CallParser::Separator::Optional, number, percentage);
+
+        if (!arguments.has_value()) {
+            return std::nullopt;
+        }
+
+        auto& [hue, saturation, lightness, _] = arguments.value();
+
+        return hslToRgb(parse360(hue), parsePercentage(saturation), parsePercentage(lightness)) | 0x000000ff;
+    }
+
+    auto separator = parser.hasCommaSeparatedArguments(4)
+        ? CallParser::Separator::Comma
+        : CallParser::Separator::Slash;
+    auto arguments = parseArguments(parser, 4, separator, number, percentage);
+
+    if (!arguments.has_value()) {
+        return std::nullopt;
+    }
+
+    auto& [hue, saturation, lightness, alpha] = arguments.value();
+
+    return hslToRgb(parse360(hue), parsePercentage(saturation), parsePercentage(lightness)) | parse1(alpha);
+}
+
+std::optional<uint32_t> parser::ColorParser::parseHwb(std::string_view color) {
+    CallParser parser(color.substr(3));
+    auto number = [&parser](){ return parser.number(); };
+    auto percentage = [&parser](){ return parser.percentage(); };
+    auto arguments = parseArguments(parser, 3, CallParser::Separator::Optional, number, percentage);
+
+    if (!arguments.has_value()) {
+        return std::nullopt;
+    }
+
+    auto& [hue, whiteness, blackness, _] = arguments.value();
+
+    return hwbToRgb(parse360(hue), parsePercentage(whiteness), parsePercentage(blackness)) | 0x000000ff;
+}
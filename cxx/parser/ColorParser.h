@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace margelo::nitro::unistyles::parser {
+
+// C++ port of React Native's normalizeColor + processColor
+// supports hex (3/4/6/8 digits), rgb(a), hsl(a), hwb, named colors and transparent
+// returns std::nullopt for anything else, so caller can fallback to JS implementation
+struct ColorParser {
+    // returns color in 0xRRGGBBAA format
+    static std::optional<uint32_t> normalizeColor(std::string_view color);
+
+    // returns color in 0xAARRGGBB format, which is understood by both platforms
+    // Android represents it as signed int, iOS as unsigned int, bits are the same
+    static std::optional<uint32_t> processColor(std::string_view color);
+
+private:
+    static std::optional<uint32_t> parseHex(std::string_view color);
+    static std::optional<uint32_t> parseNamedColor(std::string_view color);
+    static std::optional<uint32_t> parseRgb(std::string_view color);
+    static std::optional<uint32_t> parseHsl(std::string_view color);
+    static std::optional<uint32_t> parseHwb(std::string_view color);
+};
+
+}
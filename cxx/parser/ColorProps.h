@@ -0,0 +1,94 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace margelo::nitro::unistyles::parser {
+
+// React Native style props that hold a color, nested "color" covers boxShadow and dropShadow
+constexpr std::array<std::string_view, 18> COLOR_PROPS{
+    "color",
+    "backgroundColor",
+    "borderColor",
+    "borderTopColor",
+    "borderRightColor",
+    "borderBottomColor",
+    "borderLeftColor",
+    "borderStartColor",
+    "borderEndColor",
+    "borderBlockColor",
+    "borderBlockStartColor",
+    "borderBlockEndColor",
+    "outlineColor",
+    "overlayColor",
+    "shadowColor",
+    "textDecorationColor",
+    "textShadowColor",
+    "tintColor"
+};
+
+constexpr size_t COLOR_PROPS_TABLE_SIZE = 64;
+
+// FNV-1a with seed
+constexpr uint32_t hashPropertyName(std::string_view propertyName, uint32_t seed) {
+    uint32_t hash = 2166136261u ^ seed;
+
+    for (char character : propertyName) {
+        hash ^= static_cast<uint8_t>(character);
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+// finds seed for which every color prop lands in its own slot
+constexpr uint32_t findColorPropsSeed() {
+    for (uint32_t seed = 0; seed < 10000; seed++) {
+        std::array<bool, COLOR_PROPS_TABLE_SIZE> usedSlots{};
+        bool hasCollision = false;
+
+        for (auto propertyName : COLOR_PROPS) {
+            auto slot = hashPropertyName(propertyName, seed) % COLOR_PROPS_TABLE_SIZE;
+
+            if (usedSlots[slot]) {
+                hasCollision = true;
+
+                break;
+            }
+
+            usedSlots[slot] = true;
+        }
+
+        if (!hasCollision) {
+            return seed;
+        }
+    }
+
+    return UINT32_MAX;
+}
+
+constexpr uint32_t COLOR_PROPS_SEED = findColorPropsSeed();
+
+static_assert(COLOR_PROPS_SEED != UINT32_MAX, "Unistyles: unable to build perfect hash for color props.");
+
+constexpr std::array<std::string_view, COLOR_PROPS_TABLE_SIZE> COLOR_PROPS_TABLE = [](){
+    std::array<std::string_view, COLOR_PROPS_TABLE_SIZE> table{};
+
+    for (auto propertyName : COLOR_PROPS) {
+        table[hashPropertyName(propertyName, COLOR_PROPS_SEED) % COLOR_PROPS_TABLE_SIZE] = propertyName;
+    }
+
+    return table;
+}();
+
+// single hash and compare, no allocations
+constexpr bool isKnownColorProp(std::string_view propertyName) {
+    auto& slot = COLOR_PROPS_TABLE[hashPropertyName(propertyName, COLOR_PROPS_SEED) % COLOR_PROPS_TABLE_SIZE];
+
+    return !slot.empty() && slot == propertyName;
+}
+
+static_assert(isKnownColorProp("backgroundColor") && !isKnownColorProp("width"), "Unistyles: invalid color props table.");
+
+}
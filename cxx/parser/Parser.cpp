@@ -1,5 +1,6 @@
 #include "Parser.h"
 #include "UnistyleWrapper.h"
+#include <cmath>
 
 using namespace margelo::nitro::unistyles;
 using namespace facebook;
@@ -17,8 +18,8 @@ void parser::Parser::buildUnistyles(jsi::Runtime& rt, std::shared_ptr<StyleSheet
         jsi::Object styleValue = propertyValue.asObject(rt);
 
         if (styleValue.isFunction(rt)) {
-            styleSheet->unistyles[styleKey] = std::make_shared<UnistyleDynamicFunction>(
-                helpers::HashGenerator::generateHash(styleKey + std::to_string(styleSheet->tag)),
+            styleSheet->unistyles[styleKey] = helpers::makePooled<UnistyleDynamicFunction>(
+                helpers::HashGenerator::generateUnid(styleKey, styleSheet->tag),
                 UnistyleType::DynamicFunction,
                 styleKey,
                 styleValue,
@@ -28,8 +29,8 @@ void parser::Parser::buildUnistyles(jsi::Runtime& rt, std::shared_ptr<StyleSheet
             return;
         }
 
-        styleSheet->unistyles[styleKey] = std::make_shared<Unistyle>(
-            helpers::HashGenerator::generateHash(styleKey + std::to_string(styleSheet->tag)),
+        styleSheet->unistyles[styleKey] = helpers::makePooled<Unistyle>(
+            helpers::HashGenerator::generateUnid(styleKey, styleSheet->tag),
             UnistyleType::Object,
             styleKey,
             styleValue,
@@ -371,23 +372,22 @@ void parser::Parser::rebuildUnistyle(jsi::Runtime& rt, Unistyle::Shared unistyle
 }
 
 // convert dependency map to shadow tree updates
-void parser::Parser::rebuildShadowLeafUpdates(jsi::Runtime& rt, core::DependencyMap& dependencyMap) {
+void parser::Parser::rebuildShadowLeafUpdates(jsi::Runtime& rt, core::DependencyMap& dependencyMap, shadow::ShadowLane lane) {
     auto& registry = core::UnistylesRegistry::get();
+    shadow::ShadowLeafUpdates updates;
 
-    registry.trafficController.withLock([this, &rt, &dependencyMap, &registry]() {
-        shadow::ShadowLeafUpdates updates;
-        updates.reserve(dependencyMap.size());
+    updates.reserve(dependencyMap.size());
 
-        for (const auto& [shadowNode, unistyles] : dependencyMap) {
-            // Parse string colors (e.g., "#000000") to int representation
-            auto rawProps = this->parseStylesToShadowTreeStyles(rt, unistyles);
+    // parsing happens outside of traffic controller, so it never waits for the commit
+    for (const auto& [shadowNode, unistyles] : dependencyMap) {
+        // Parse string colors (e.g., "#000000") to int representation
+        auto rawProps = this->parseStylesToShadowTreeStyles(rt, unistyles);
 
-            updates.emplace(shadowNode, std::move(rawProps));
-        }
+        updates.emplace(shadowNode, std::move(rawProps));
+    }
 
-        registry.trafficController.setUpdates(updates);
-        registry.trafficController.resumeUnistylesTraffic();
-    });
+    registry.trafficController.setUpdates(std::move(updates), lane);
+    registry.trafficController.resumeUnistylesTraffic();
 }
 
 
@@ -400,46 +400,55 @@ jsi::Object parser::Parser::parseFirstLevel(jsi::Runtime& rt, Unistyle::Shared u
         ? unistyle->rawValue
         : std::dynamic_pointer_cast<UnistyleDynamicFunction>(unistyle)->unprocessedValue.value();
     auto parsedStyle = jsi::Object(rt);
+    auto& properties = core::UnistylesRegistry::get().getState(rt).getPropertyTable();
 
     // we need to be sure that compoundVariants are parsed after variants and after every other style
-    bool shouldParseVariants = style.hasProperty(rt, "variants");
-    bool shouldParseCompoundVariants = style.hasProperty(rt, "compoundVariants") && shouldParseVariants;
+    bool shouldParseVariants = style.hasProperty(rt, properties.get(core::KnownProperty::VARIANTS).propNameID);
+    bool shouldParseCompoundVariants = style.hasProperty(rt, properties.get(core::KnownProperty::COMPOUND_VARIANTS).propNameID) && shouldParseVariants;
 
-    helpers::enumerateJSIObject(rt, style, [&](const std::string& propertyName, jsi::Value& propertyValue){
-        // parse dependencies only once
-        if (propertyName == helpers::STYLE_DEPENDENCIES && !unistyle->isSealed()) {
-            auto newDeps = this->parseDependencies(rt, propertyValue.asObject(rt));
+    properties.forEach(rt, style, [&](const core::Property& property, jsi::Value& propertyValue){
+        switch (property.known()) {
+            case core::KnownProperty::STYLE_DEPENDENCIES:
+                // parse dependencies only once
+                if (!unistyle->isSealed()) {
+                    unistyle->addDependencies(this->parseDependencies(rt, propertyValue.asObject(rt)));
 
-            unistyle->dependencies.insert(unistyle->dependencies.end(), newDeps.begin(), newDeps.end());
+                    return;
+                }
 
-            return;
-        }
+                if (!unistyle->dependencies.empty()) {
+                    return;
+                }
 
-        if (propertyName == helpers::STYLE_DEPENDENCIES && !unistyle->dependencies.empty()) {
-            return;
-        }
+                break;
 
-        // ignore web styles
-        if (propertyName == helpers::WEB_STYLE_KEY) {
-            return;
-        }
+            // ignore web styles
+            case core::KnownProperty::WEB_STYLE:
+                return;
 
-        // special case as we need to convert it to jsi::Array<jsi::Object>
-        if (propertyName == "boxShadow" && propertyValue.isString()) {
-            parsedStyle.setProperty(rt, jsi::PropNameID::forUtf8(rt, propertyName), parseBoxShadowString(rt, propertyValue.asString(rt).utf8(rt)));
+            // special case as we need to convert it to jsi::Array<jsi::Object>
+            case core::KnownProperty::BOX_SHADOW:
+                if (propertyValue.isString()) {
+                    parsedStyle.setProperty(rt, property.propNameID, parseBoxShadowString(rt, propertyValue.asString(rt).utf8(rt)));
 
-            return;
+                    return;
+                }
+
+                break;
+
+            default:
+                break;
         }
 
         // primitives
         if (propertyValue.isNumber() || propertyValue.isString() || propertyValue.isUndefined() || propertyValue.isNull()) {
-            parsedStyle.setProperty(rt, jsi::PropNameID::forUtf8(rt, propertyName), propertyValue);
+            parsedStyle.setProperty(rt, property.propNameID, propertyValue);
 
             return;
         }
         
-        if (propertyValue.isBool() && propertyName == "includeFontPadding") {
-            parsedStyle.setProperty(rt, jsi::PropNameID::forUtf8(rt, propertyName), propertyValue);
+        if (propertyValue.isBool() && property.known() == core::KnownProperty::INCLUDE_FONT_PADDING) {
+            parsedStyle.setProperty(rt, property.propNameID, propertyValue);
             
             return;
         }
@@ -456,43 +465,60 @@ jsi::Object parser::Parser::parseFirstLevel(jsi::Runtime& rt, Unistyle::Shared u
             return;
         }
 
-        // variants and compoundVariants are computed soon after all styles
-        if (propertyName == "variants" || propertyName == "compoundVariants") {
-            return;
-        }
+        switch (property.known()) {
+            // variants and compoundVariants are computed soon after all styles
+            case core::KnownProperty::VARIANTS:
+            case core::KnownProperty::COMPOUND_VARIANTS:
+                return;
 
-        if (propertyName == "transform" && propertyValueObject.isArray(rt)) {
-            parsedStyle.setProperty(rt, jsi::PropNameID::forUtf8(rt, propertyName), parseTransforms(rt, unistyle, propertyValueObject));
+            case core::KnownProperty::TRANSFORM:
+                if (propertyValueObject.isArray(rt)) {
+                    parsedStyle.setProperty(rt, property.propNameID, parseTransforms(rt, unistyle, propertyValueObject));
 
-            return;
-        }
+                    return;
+                }
 
-        if (propertyName == "boxShadow" && propertyValueObject.isArray(rt)) {
-            parsedStyle.setProperty(rt, jsi::PropNameID::forUtf8(rt, propertyName), parseBoxShadow(rt, unistyle, propertyValueObject));
+                break;
 
-            return;
-        }
+            case core::KnownProperty::BOX_SHADOW:
+                if (propertyValueObject.isArray(rt)) {
+                    parsedStyle.setProperty(rt, property.propNameID, parseBoxShadow(rt, unistyle, propertyValueObject));
 
-        if (propertyName == "filter" && propertyValueObject.isArray(rt)) {
-            parsedStyle.setProperty(rt, jsi::PropNameID::forUtf8(rt, propertyName), parseFilters(rt, unistyle, propertyValueObject));
+                    return;
+                }
 
-            return;
-        }
+                break;
 
-        if (propertyName == "fontVariant" && propertyValueObject.isArray(rt)) {
-            parsedStyle.setProperty(rt, jsi::PropNameID::forUtf8(rt, propertyName), propertyValue);
+            case core::KnownProperty::FILTER:
+                if (propertyValueObject.isArray(rt)) {
+                    parsedStyle.setProperty(rt, property.propNameID, parseFilters(rt, unistyle, propertyValueObject));
 
-            return;
-        }
+                    return;
+                }
 
-        if (propertyName == "shadowOffset" || propertyName == "textShadowOffset") {
-            parsedStyle.setProperty(rt, jsi::PropNameID::forUtf8(rt, propertyName), this->parseSecondLevel(rt, unistyle, propertyValue));
+                break;
 
-            return;
+            case core::KnownProperty::FONT_VARIANT:
+                if (propertyValueObject.isArray(rt)) {
+                    parsedStyle.setProperty(rt, property.propNameID, propertyValue);
+
+                    return;
+                }
+
+                break;
+
+            case core::KnownProperty::SHADOW_OFFSET:
+            case core::KnownProperty::TEXT_SHADOW_OFFSET:
+                parsedStyle.setProperty(rt, property.propNameID, this->parseSecondLevel(rt, unistyle, propertyValue));
+
+                return;
+
+            default:
+                break;
         }
 
         if (helpers::isPlatformColor(rt, propertyValueObject)) {
-            parsedStyle.setProperty(rt, jsi::PropNameID::forUtf8(rt, propertyName), propertyValueObject);
+            parsedStyle.setProperty(rt, property.propNameID, propertyValueObject);
 
             return;
         }
@@ -500,17 +526,17 @@ jsi::Object parser::Parser::parseFirstLevel(jsi::Runtime& rt, Unistyle::Shared u
         // 'mq' or 'breakpoints'
         auto valueFromBreakpoint = getValueFromBreakpoints(rt, unistyle, propertyValueObject);
 
-        parsedStyle.setProperty(rt, jsi::PropNameID::forUtf8(rt, propertyName), this->parseSecondLevel(rt, unistyle, valueFromBreakpoint));
+        parsedStyle.setProperty(rt, property.propNameID, this->parseSecondLevel(rt, unistyle, valueFromBreakpoint));
     });
 
     if (shouldParseVariants && variants.has_value()) {
-        auto propertyValueObject = style.getProperty(rt, "variants").asObject(rt);
+        auto propertyValueObject = style.getProperty(rt, properties.get(core::KnownProperty::VARIANTS).propNameID).asObject(rt);
         auto parsedVariant = this->parseVariants(rt, unistyle, propertyValueObject, variants.value());
 
         helpers::mergeJSIObjects(rt, parsedStyle, parsedVariant);
 
         if (shouldParseCompoundVariants) {
-            auto compoundVariants = style.getProperty(rt, "compoundVariants").asObject(rt);
+            auto compoundVariants = style.getProperty(rt, properties.get(core::KnownProperty::COMPOUND_VARIANTS).propNameID).asObject(rt);
             auto parsedCompoundVariants = this->parseCompoundVariants(rt, unistyle, compoundVariants, variants.value());
 
             helpers::mergeJSIObjects(rt, parsedStyle, parsedCompoundVariants);
@@ -558,17 +584,24 @@ jsi::Function parser::Parser::createDynamicFunctionProxy(jsi::Runtime& rt, Unist
 }
 
 // function converts babel generated dependencies to C++ dependencies
-std::vector<UnistyleDependency> parser::Parser::parseDependencies(jsi::Runtime &rt, jsi::Object&& dependencies) {
+helpers::DependencyMask parser::Parser::parseDependencies(jsi::Runtime &rt, jsi::Object&& dependencies) {
     helpers::assertThat(rt, dependencies.isArray(rt), "Unistyles: Babel transform is invalid - unexpected type for dependencies.");
 
-    std::vector<UnistyleDependency> parsedDependencies{};
-
-    parsedDependencies.reserve(5);
+    helpers::DependencyMask parsedDependencies{};
 
     helpers::iterateJSIArray(rt, dependencies.asArray(rt), [&](size_t i, jsi::Value& value){
-        auto dependency = static_cast<UnistyleDependency>(value.asNumber());
+        auto rawDependency = value.isNumber() ? value.asNumber() : -1;
+
+        // mask shift is undefined for negative, fractional or too big values
+        helpers::assertThat(
+            rt,
+            rawDependency >= 0 && rawDependency <= static_cast<double>(UnistyleDependency::RTL) && rawDependency == std::floor(rawDependency),
+            "Unistyles: Babel transform is invalid - unexpected dependency."
+        );
 
-        parsedDependencies.push_back(dependency);
+        auto dependency = static_cast<UnistyleDependency>(rawDependency);
+
+        parsedDependencies.add(dependency);
     });
 
     return parsedDependencies;
@@ -677,76 +710,82 @@ jsi::Value parser::Parser::parseFilters(jsi::Runtime &rt, Unistyle::Shared unist
 jsi::Value parser::Parser::getValueFromBreakpoints(jsi::Runtime& rt, Unistyle::Shared unistyle, jsi::Object& obj) {
     auto& registry = core::UnistylesRegistry::get();
     auto& state = registry.getState(rt);
-
-    auto sortedBreakpoints = state.getSortedBreakpointPairs();
-    auto hasBreakpoints = !sortedBreakpoints.empty();
-    auto currentBreakpoint = state.getCurrentBreakpointName();
-    auto rawDimensions = this->_unistylesRuntime->getScreen();
-    auto pixelRatio = this->_unistylesRuntime->getPixelRatio();
-    auto dimensions = registry.shouldUsePointsForBreakpoints
-        ? Dimensions(rawDimensions.width / pixelRatio, rawDimensions.height / pixelRatio)
-        : rawDimensions;
-    auto currentOrientation = dimensions.width > dimensions.height
-        ? "landscape"
-        : "portrait";
-
-    jsi::Array propertyNames = obj.getPropertyNames(rt);
-    size_t length = propertyNames.size(rt);
+    auto compiledBreakpoints = this->getCompiledBreakpoints(rt, obj);
+    auto hasBreakpoints = !state.getSortedBreakpointPairs().empty();
+    auto hasOrientationBreakpoint = compiledBreakpoints->hasOrientation();
+    std::optional<Dimensions> dimensions = std::nullopt;
+
+    // screen dimensions are needed only for mq and orientation
+    if (!compiledBreakpoints->mqs.empty() || hasOrientationBreakpoint) {
+        auto rawDimensions = this->_unistylesRuntime->getScreen();
+        auto pixelRatio = this->_unistylesRuntime->getPixelRatio();
+
+        dimensions = registry.shouldUsePointsForBreakpoints
+            ? Dimensions(rawDimensions.width / pixelRatio, rawDimensions.height / pixelRatio)
+            : rawDimensions;
+    }
 
     // mq has the biggest priority, so check if first
-    for (size_t i = 0; i < length; i++) {
-        auto propertyName = propertyNames.getValueAtIndex(rt, i).asString(rt).utf8(rt);
-        auto propertyValue = obj.getProperty(rt, propertyName.c_str());
-        auto mq = core::UnistylesMQ{propertyName};
-
-        if (mq.isMQ()) {
-            unistyle->addBreakpointDependency();
-        }
+    for (auto& compiledMQ : compiledBreakpoints->mqs) {
+        unistyle->addBreakpointDependency();
 
-        if (mq.isWithinTheWidthAndHeight(dimensions)) {
+        if (compiledMQ.mq.isWithinTheWidthAndHeight(dimensions.value())) {
             // we have direct hit
-            return propertyValue;
+            return jsi::Value(rt, compiledMQ.value);
         }
     }
 
     // check orientation breakpoints if user didn't register own breakpoint
-    bool hasOrientationBreakpoint = obj.hasProperty(rt, currentOrientation);
-
     if (hasOrientationBreakpoint) {
         unistyle->addBreakpointDependency();
     }
 
     if (!hasBreakpoints && hasOrientationBreakpoint) {
-        return obj.getProperty(rt, currentOrientation);
+        auto& orientationValue = compiledBreakpoints->getOrientationValue(dimensions->width > dimensions->height);
+
+        return orientationValue.has_value()
+            ? jsi::Value(rt, orientationValue.value())
+            : jsi::Value::undefined();
     }
 
-    if (!currentBreakpoint.has_value()) {
+    auto currentBreakpointIndex = state.getCurrentBreakpointIndex();
+
+    if (!currentBreakpointIndex.has_value()) {
         return jsi::Value::undefined();
     }
 
     unistyle->addBreakpointDependency();
 
     // if you're still here it means that there is no
-    // matching mq nor default breakpoint, let's find the user defined breakpoint
-    auto currentBreakpointIt = std::find_if(
-        sortedBreakpoints.rbegin(),
-        sortedBreakpoints.rend(),
-        [&currentBreakpoint](const std::pair<std::string, double>& breakpoint){
-            return breakpoint.first == currentBreakpoint.value();
+    // matching mq nor default breakpoint, let's find the closest user defined breakpoint
+    return compiledBreakpoints->getBreakpointValue(rt, currentBreakpointIndex.value());
+}
+
+// breakpoint objects are compiled once and reused until user registers new breakpoints
+std::shared_ptr<core::CompiledBreakpoints> parser::Parser::getCompiledBreakpoints(jsi::Runtime& rt, jsi::Object& obj) {
+    auto& state = core::UnistylesRegistry::get().getState(rt);
+    auto breakpointsGeneration = state.getBreakpointsGeneration();
+
+    if (obj.hasNativeState<core::CompiledBreakpoints>(rt)) {
+        auto compiledBreakpoints = obj.getNativeState<core::CompiledBreakpoints>(rt);
+
+        if (compiledBreakpoints->breakpointsGeneration == breakpointsGeneration) {
+            return compiledBreakpoints;
         }
-    );
+    }
 
-    // look for any hit in reversed vector
-    for (auto it = currentBreakpointIt; it != sortedBreakpoints.rend(); ++it) {
-        auto breakpoint = it->first.c_str();
+    auto compiledBreakpoints = core::CompiledBreakpoints::compile(rt, obj, state.getSortedBreakpointPairs(), breakpointsGeneration);
 
-        if (obj.hasProperty(rt, breakpoint)) {
-            return obj.getProperty(rt, breakpoint);
+    // never override someone else's native state
+    if (!obj.hasNativeState(rt) || obj.hasNativeState<core::CompiledBreakpoints>(rt)) {
+        try {
+            obj.setNativeState(rt, compiledBreakpoints);
+        } catch (...) {
+            // frozen objects and proxies can't hold native state, they will be compiled on every parse
         }
     }
 
-    // at this point we have no match, return undefined
-    return jsi::Value::undefined();
+    return compiledBreakpoints;
 }
 
 // parse all types of variants
@@ -885,26 +924,27 @@ jsi::Value parser::Parser::parseSecondLevel(jsi::Runtime &rt, Unistyle::Shared u
     }
 
     jsi::Object parsedStyle = jsi::Object(rt);
+    auto& properties = core::UnistylesRegistry::get().getState(rt).getPropertyTable();
 
-    helpers::enumerateJSIObject(rt, nestedObjectStyle, [&](const std::string& propertyName, jsi::Value& propertyValue){
+    properties.forEach(rt, nestedObjectStyle, [&](const core::Property& property, jsi::Value& propertyValue){
         // special case as we need to convert it to jsi::Array<jsi::Object>
         // possible with variants and compoundVariants
-        if (propertyName == "boxShadow" && propertyValue.isString()) {
-            parsedStyle.setProperty(rt, jsi::PropNameID::forUtf8(rt, propertyName), parseBoxShadowString(rt, propertyValue.asString(rt).utf8(rt)));
+        if (property.known() == core::KnownProperty::BOX_SHADOW && propertyValue.isString()) {
+            parsedStyle.setProperty(rt, property.propNameID, parseBoxShadowString(rt, propertyValue.asString(rt).utf8(rt)));
 
             return;
         }
 
         // primitives, bool is possible for boxShadow inset
         if (propertyValue.isString() || propertyValue.isNumber() || propertyValue.isUndefined() || propertyValue.isNull() || propertyValue.isBool()) {
-            parsedStyle.setProperty(rt, propertyName.c_str(), propertyValue);
+            parsedStyle.setProperty(rt, property.propNameID, propertyValue);
 
             return;
         }
 
         // ignore any non objects at this level
         if (!propertyValue.isObject()) {
-            parsedStyle.setProperty(rt, propertyName.c_str(), jsi::Value::undefined());
+            parsedStyle.setProperty(rt, property.propNameID, jsi::Value::undefined());
 
             return;
         }
@@ -912,7 +952,7 @@ jsi::Value parser::Parser::parseSecondLevel(jsi::Runtime &rt, Unistyle::Shared u
         auto nestedObjectStyle = propertyValue.asObject(rt);
 
         if (nestedObjectStyle.isFunction(rt)) {
-            parsedStyle.setProperty(rt, propertyName.c_str(), jsi::Value::undefined());
+            parsedStyle.setProperty(rt, property.propNameID, jsi::Value::undefined());
 
             return;
         }
@@ -920,38 +960,39 @@ jsi::Value parser::Parser::parseSecondLevel(jsi::Runtime &rt, Unistyle::Shared u
         auto isArray = nestedObjectStyle.isArray(rt);
 
         if (!isArray) {
-            parsedStyle.setProperty(rt, propertyName.c_str(), this->getValueFromBreakpoints(rt, unistyle, nestedObjectStyle));
+            parsedStyle.setProperty(rt, property.propNameID, this->getValueFromBreakpoints(rt, unistyle, nestedObjectStyle));
         }
 
         // possible with variants and compoundVariants
-        if (propertyName == "transform") {
-            parsedStyle.setProperty(rt, propertyName.c_str(), parseTransforms(rt, unistyle, nestedObjectStyle));
+        switch (property.known()) {
+            case core::KnownProperty::TRANSFORM:
+                parsedStyle.setProperty(rt, property.propNameID, parseTransforms(rt, unistyle, nestedObjectStyle));
 
-            return;
-        }
+                return;
 
-        if (propertyName == "boxShadow") {
-            parsedStyle.setProperty(rt, propertyName.c_str(), parseBoxShadow(rt, unistyle, nestedObjectStyle));
+            case core::KnownProperty::BOX_SHADOW:
+                parsedStyle.setProperty(rt, property.propNameID, parseBoxShadow(rt, unistyle, nestedObjectStyle));
 
-            return;
-        }
+                return;
 
-        if (propertyName == "filter") {
-            parsedStyle.setProperty(rt, propertyName.c_str(), parseFilters(rt, unistyle, nestedObjectStyle));
+            case core::KnownProperty::FILTER:
+                parsedStyle.setProperty(rt, property.propNameID, parseFilters(rt, unistyle, nestedObjectStyle));
 
-            return;
-        }
+                return;
 
-        if (propertyName == "fontVariant") {
-            parsedStyle.setProperty(rt, propertyName.c_str(), propertyValue);
+            case core::KnownProperty::FONT_VARIANT:
+                parsedStyle.setProperty(rt, property.propNameID, propertyValue);
 
-            return;
-        }
+                return;
 
-        if (propertyName == "shadowOffset" || propertyName == "textShadowOffset") {
-            parsedStyle.setProperty(rt, propertyName.c_str(), this->parseSecondLevel(rt, unistyle, propertyValue));
+            case core::KnownProperty::SHADOW_OFFSET:
+            case core::KnownProperty::TEXT_SHADOW_OFFSET:
+                parsedStyle.setProperty(rt, property.propNameID, this->parseSecondLevel(rt, unistyle, propertyValue));
 
-            return;
+                return;
+
+            default:
+                return;
         }
     });
 
@@ -959,113 +1000,95 @@ jsi::Value parser::Parser::parseSecondLevel(jsi::Runtime &rt, Unistyle::Shared u
 }
 
 // convert unistyles to folly with int colors
+// emits folly::dynamic directly, without intermediate jsi::Object
+// mirrors jsi::dynamicFromValue: undefined properties are skipped and functions become null
 folly::dynamic parser::Parser::parseStylesToShadowTreeStyles(jsi::Runtime& rt, const std::vector<std::shared_ptr<UnistyleData>>& unistyles) {
-    jsi::Object convertedStyles(rt);
+    folly::dynamic convertedStyles = folly::dynamic::object();
     auto& state = core::UnistylesRegistry::get().getState(rt);
+    auto& properties = state.getPropertyTable();
+    auto toDynamic = [&rt](jsi::Value& value) -> folly::dynamic {
+        if (value.isObject() && value.asObject(rt).isFunction(rt)) {
+            return nullptr;
+        }
+
+        return jsi::dynamicFromValue(rt, value);
+    };
 
     for (const auto& unistyleData : unistyles) {
         if (!unistyleData->parsedStyle.has_value()) {
             continue;
         }
 
-        helpers::enumerateJSIObject(
+        properties.forEach(
             rt,
             unistyleData->parsedStyle.value(),
-            [this, &rt, &state, &convertedStyles](const std::string& propertyName, jsi::Value& propertyValue) {
-                if (this->isColor(propertyName)) {
-                    convertedStyles.setProperty(
-                        rt,
-                        propertyName.c_str(),
-                        jsi::Value(state.parseColor(propertyValue))
-                    );
+            [&rt, &state, &properties, &convertedStyles, &toDynamic](const core::Property& property, jsi::Value& propertyValue) {
+                auto& propertyName = property.name;
+
+                if (property.isColor) {
+                    convertedStyles[propertyName] = state.parseColor(propertyValue);
 
                     return;
                 }
 
-                if (!propertyValue.isObject()) {
-                    convertedStyles.setProperty(
-                        rt,
-                        propertyName.c_str(),
-                        propertyValue
-                    );
+                // undefined overrides value from previous unistyle
+                if (propertyValue.isUndefined()) {
+                    convertedStyles.erase(propertyName);
 
                     return;
                 }
 
-                jsi::Object objValue = propertyValue.asObject(rt);
-
-                if (!objValue.isArray(rt)) {
-                    convertedStyles.setProperty(
-                        rt,
-                        propertyName.c_str(),
-                        propertyValue
-                    );
+                if (!propertyValue.isObject() || !propertyValue.asObject(rt).isArray(rt)) {
+                    convertedStyles[propertyName] = toDynamic(propertyValue);
 
                     return;
                 }
 
                 // parse nested arrays like boxShadow
-                jsi::Array arrValue = objValue.asArray(rt);
-                size_t arrLen = arrValue.length(rt);
-                jsi::Array parsedArray(rt, arrLen);
+                folly::dynamic parsedArray = folly::dynamic::array();
 
                 helpers::iterateJSIArray(
                     rt,
-                    arrValue,
-                    [this, &rt, &state, &propertyName, &parsedArray](size_t i, jsi::Value& nestedValue) {
+                    propertyValue.asObject(rt).asArray(rt),
+                    [&rt, &state, &properties, &property, &parsedArray, &toDynamic](size_t i, jsi::Value& nestedValue) {
                         if (nestedValue.isObject()) {
-                            jsi::Object obj(rt);
+                            folly::dynamic obj = folly::dynamic::object();
 
-                            helpers::enumerateJSIObject(
+                            properties.forEach(
                                 rt,
                                 nestedValue.asObject(rt),
-                                [this, &rt, &state, &obj](const std::string& nestedPropName, jsi::Value& nestedPropValue) {
-                                    if (this->isColor(nestedPropName)) {
-                                        obj.setProperty(
-                                            rt,
-                                            nestedPropName.c_str(),
-                                            state.parseColor(nestedPropValue)
-                                        );
-                                    } else {
-                                        obj.setProperty(
-                                            rt,
-                                            nestedPropName.c_str(),
-                                            nestedPropValue
-                                        );
+                                [&state, &obj, &toDynamic](const core::Property& nestedProperty, jsi::Value& nestedPropValue) {
+                                    if (nestedProperty.isColor) {
+                                        obj[nestedProperty.name] = state.parseColor(nestedPropValue);
+
+                                        return;
+                                    }
+
+                                    if (!nestedPropValue.isUndefined()) {
+                                        obj[nestedProperty.name] = toDynamic(nestedPropValue);
                                     }
                                 }
                             );
 
-                            parsedArray.setValueAtIndex(rt, i, obj);
+                            parsedArray.push_back(std::move(obj));
 
                             return;
                         }
 
-                        if (this->isColor(propertyName)) {
-                            parsedArray.setValueAtIndex(
-                                rt,
-                                i,
-                                jsi::Value(state.parseColor(nestedValue))
-                            );
-                        } else {
-                            parsedArray.setValueAtIndex(rt, i, nestedValue);
+                        if (property.isColor) {
+                            parsedArray.push_back(state.parseColor(nestedValue));
+
+                            return;
                         }
+
+                        parsedArray.push_back(toDynamic(nestedValue));
                     }
                 );
 
-                convertedStyles.setProperty(rt, propertyName.c_str(), parsedArray);
+                convertedStyles[propertyName] = std::move(parsedArray);
             }
         );
     }
 
-    return jsi::dynamicFromValue(rt, jsi::Value(rt, convertedStyles));
-}
-
-
-// check is styleKey contains color
-bool parser::Parser::isColor(const std::string& propertyName) {
-    std::string str = propertyName;
-    std::transform(str.begin(), str.end(), str.begin(), ::tolower);
-
-    return str.find("color") != std::string::npos;
+    return convertedStyles;
 }
@@ -3,6 +3,7 @@
 #include <jsi/jsi.h>
 #include <folly/dynamic.h>
 #include <react/renderer/uimanager/UIManager.h>
+#include "DependencyMask.h"
 
 namespace margelo::nitro::unistyles::shadow {
 
@@ -11,5 +12,31 @@ using namespace facebook::react;
 
 // translates Unistyles changes to unified shadow tree changes
 using ShadowLeafUpdates = std::unordered_map<const ShadowNodeFamily*, folly::dynamic>;
+// updates grouped by surface, so every surface can be committed separately
+using SurfaceUpdates = std::unordered_map<SurfaceId, ShadowLeafUpdates>;
+
+// urgent updates are committed every frame
+// visible deferred ones land with them in single commit, off-screen ones are time sliced in idle time
+enum class ShadowLane {
+    URGENT,
+    DEFERRED
+};
+
+// changes that are not bound to user's interaction or animation
+constexpr helpers::DependencyMask DEFERRED_DEPENDENCIES{
+    helpers::DependencyMask::bitFor(UnistyleDependency::THEME) |
+    helpers::DependencyMask::bitFor(UnistyleDependency::THEMENAME) |
+    helpers::DependencyMask::bitFor(UnistyleDependency::ADAPTIVETHEMES) |
+    helpers::DependencyMask::bitFor(UnistyleDependency::COLORSCHEME) |
+    helpers::DependencyMask::bitFor(UnistyleDependency::FONTSCALE) |
+    helpers::DependencyMask::bitFor(UnistyleDependency::CONTENTSIZECATEGORY)
+};
+
+// single urgent dependency (eg. IME or insets) makes whole update urgent
+inline ShadowLane getShadowLane(helpers::DependencyMask dependencies) {
+    return dependencies.empty() || dependencies.intersects(helpers::DependencyMask{~DEFERRED_DEPENDENCIES.bits})
+        ? ShadowLane::URGENT
+        : ShadowLane::DEFERRED;
+}
 
 }
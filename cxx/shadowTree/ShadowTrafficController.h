@@ -1,13 +1,91 @@
 #pragma once
 
 #import "mutex"
+#import <algorithm>
+#import <atomic>
+#import <memory>
+#import <functional>
+#import <optional>
+#import <tuple>
+#import <unordered_set>
+#import <utility>
 #import "ShadowLeafUpdate.h"
 
 namespace margelo::nitro::unistyles::shadow {
 
+struct ShadowTrafficStats {
+    // shadow leaf updates received from Unistyles
+    size_t receivedUpdates = 0;
+    // updates that replaced a not yet committed update of the same shadow node
+    size_t mergedUpdates = 0;
+    // flush requests folded into an already scheduled flush
+    size_t coalescedFlushes = 0;
+    // updates dropped before the commit, as shadow node already had the same props
+    size_t unchangedUpdates = 0;
+    size_t commits = 0;
+};
+
+// single producer call, pushed to lock free queue
+// surface is resolved by producer, as shadow node family may be already gone when batch is applied
+struct ShadowTrafficBatch {
+    SurfaceUpdates updates{};
+    ShadowLane lane = ShadowLane::URGENT;
+    std::vector<std::pair<const ShadowNodeFamily*, SurfaceId>> removedFamilies{};
+    ShadowTrafficBatch* next = nullptr;
+};
+
+// where shadow node is in the last committed shadow tree
+struct ShadowLeafPlacement {
+    // off-screen deferred updates are committed in idle time
+    bool isOffscreen = false;
+    // pre-order index in the shadow tree, so chunks taken in this order share ancestors
+    size_t treeOrder = SIZE_MAX;
+    // placement is valid as long as shadow tree stays at this revision
+    std::optional<ShadowTreeRevision::Number> revision{};
+};
+
+using ShadowLeafPlacements = std::unordered_map<const ShadowNodeFamily*, ShadowLeafPlacement>;
+
+// pending shadow nodes of single surface
+struct PendingSurface {
+    std::unordered_set<const ShadowNodeFamily*> families{};
+    // set only if all of them were placed in the same shadow tree revision
+    std::optional<ShadowTreeRevision::Number> placedRevision{};
+};
+
+struct PendingShadowLeaf {
+    SurfaceId surfaceId;
+    ShadowLane lane;
+    // order in which shadow node was queued, merged updates keep the oldest one
+    size_t sequence = 0;
+    ShadowLeafPlacement placement{};
+};
+
+// called once all updates queued before it was added are committed
+struct ShadowCommitListener {
+    size_t sequence;
+    std::function<void()> listener;
+};
+
+// taken by the committer, props become committed only if shadow node was found and commit succeeded
+struct InflightShadowLeaf {
+    PendingShadowLeaf pendingLeaf;
+    folly::dynamic props;
+};
+
+using CommittedFamilies = std::unordered_map<SurfaceId, std::unordered_set<const ShadowNodeFamily*>>;
+
 // Like a traffic officer managing a jam, this struct ensures everything
 // is synchronized within a set timeframe, controlling flow and preventing chaos.
+//
+// Producers (link, unlink, dependency rebuilds) never wait for the commit, they push batches to the lock free queue.
+// Committer takes the whole queue at once and merges it into its own store within withLock,
+// which is held only for this bookkeeping, not for the shadow tree commit.
 struct ShadowTrafficController {
+    ~ShadowTrafficController() {
+        deleteBatches(_batches.exchange(nullptr, std::memory_order_acquire));
+    }
+
     inline bool shouldStop() {
         return !_canCommit;
     }
@@ -20,39 +98,311 @@ struct ShadowTrafficController {
         this->_canCommit = true;
     }
 
-    inline shadow::ShadowLeafUpdates& getUpdates() {
+    inline void setUpdates(shadow::ShadowLeafUpdates&& newUpdates, ShadowLane lane = ShadowLane::URGENT) {
+        // safe to call from any thread
+        // use it for complete, flattened styles, props missing from them will be reset
+        pushBatch(createBatch(std::move(newUpdates), lane));
+    }
+
+    inline void removeShadowNode(const ShadowNodeFamily* shadowNodeFamily) {
+        // safe to call from any thread
+        auto batch = new ShadowTrafficBatch{};
+
+        batch->removedFamilies.emplace_back(shadowNodeFamily, shadowNodeFamily->getSurfaceId());
+
+        pushBatch(batch);
+    }
+
+    inline shadow::SurfaceUpdates takeUncommittedUpdates(std::optional<ShadowLane> lane = std::nullopt, size_t maxUpdates = SIZE_MAX, bool includeOffscreen = true) {
         // call it only within withLock!
-        return _unistylesUpdates;
+        // returns only props that differ from the last committed ones, they stay in flight until settleInflightUpdates
+        // without lane, all pending updates are taken
+        shadow::SurfaceUpdates uncommittedUpdates{};
+
+        drainBatches();
+
+        for (auto& [family, pendingLeaf] : takePendingFamilies(lane, maxUpdates, includeOffscreen)) {
+            auto surfaceId = pendingLeaf.surfaceId;
+            auto surfaceUpdates = _unistylesUpdates.find(surfaceId);
+
+            if (surfaceUpdates == _unistylesUpdates.end()) {
+                continue;
+            }
+
+            auto update = surfaceUpdates->second.find(family);
+
+            if (update == surfaceUpdates->second.end()) {
+                continue;
+            }
+
+            auto& surfaceCommittedProps = _committedProps[surfaceId];
+            auto committedProps = surfaceCommittedProps.find(family);
+
+            // first commit for this shadow node, so we need all the props
+            if (committedProps == surfaceCommittedProps.end()) {
+                _inflightFamilies.insert_or_assign(family, InflightShadowLeaf{pendingLeaf, update->second});
+                uncommittedUpdates[surfaceId].emplace(family, update->second);
+
+                continue;
+            }
+
+            auto changedProps = diffProps(committedProps->second, update->second);
+
+            if (changedProps.isObject() && changedProps.empty()) {
+                _stats.unchangedUpdates++;
+
+                continue;
+            }
+
+            _inflightFamilies.insert_or_assign(family, InflightShadowLeaf{pendingLeaf, update->second});
+            uncommittedUpdates[surfaceId].emplace(family, std::move(changedProps));
+        }
+
+        return uncommittedUpdates;
     }
 
-    inline void setUpdates(shadow::ShadowLeafUpdates& newUpdates) {
+    inline size_t settleInflightUpdates(const CommittedFamilies& committedFamilies) {
         // call it only within withLock!
-        auto& targetUpdates = _unistylesUpdates;
+        // shadow nodes that were not committed (eg. missing surface, not mounted yet or cancelled commit)
+        // are pending again, so their props are not lost and are retried with the next flush
+        size_t committedUpdates = 0;
 
-        // this is important as overriding updates may skip some interim changes
-        // Unistyles emits different events so this will make sure that everything is synced
-        std::for_each(newUpdates.begin(), newUpdates.end(), [&targetUpdates](auto& pair){
-            if (targetUpdates.contains(pair.first)) {
-                targetUpdates[pair.first] = std::move(pair.second);
+        drainBatches();
 
-                return;
+        for (auto& [family, inflightLeaf] : _inflightFamilies) {
+            auto surfaceId = inflightLeaf.pendingLeaf.surfaceId;
+            auto surfaceCommittedFamilies = committedFamilies.find(surfaceId);
+
+            if (surfaceCommittedFamilies != committedFamilies.end() && surfaceCommittedFamilies->second.contains(family)) {
+                _committedProps[surfaceId].insert_or_assign(family, std::move(inflightLeaf.props));
+                committedUpdates++;
+
+                continue;
             }
 
-            targetUpdates.emplace(pair.first, std::move(pair.second));
+            // newer update may be pending already, then it's committed with it
+            // otherwise it's queued again, so commit listeners added before don't wait for the retry
+            _pendingFamilies.try_emplace(family, PendingShadowLeaf{surfaceId, inflightLeaf.pendingLeaf.lane, ++_sequence});
+        }
+
+        _inflightFamilies.clear();
+
+        return committedUpdates;
+    }
+
+    inline const shadow::ShadowLeafUpdates* getCommittedUpdates(SurfaceId surfaceId) {
+        // call it only within withLock!
+        // full props, unlike committed update which may contain only changed ones
+        // queued batches are applied first, so pending shadow nodes are known
+        drainBatches();
+
+        auto committedProps = _committedProps.find(surfaceId);
+
+        return committedProps == _committedProps.end()
+            ? nullptr
+            : &committedProps->second;
+    }
+
+    inline bool hasPendingUpdate(const ShadowNodeFamily* shadowNodeFamily) {
+        // call it only within withLock!
+        return _pendingFamilies.contains(shadowNodeFamily);
+    }
+
+    inline void forgetCommittedProps(SurfaceId surfaceId, const ShadowNodeFamily* shadowNodeFamily) {
+        // call it only within withLock!
+        // next commit of this shadow node will contain all of its props, not only changed ones
+        auto surfaceCommittedProps = _committedProps.find(surfaceId);
+
+        if (surfaceCommittedProps == _committedProps.end()) {
+            return;
+        }
+
+        surfaceCommittedProps->second.erase(shadowNodeFamily);
+
+        if (surfaceCommittedProps->second.empty()) {
+            _committedProps.erase(surfaceCommittedProps);
+        }
+    }
+
+    inline bool hasPendingUpdates() {
+        // call it only within withLock!
+        return _batches.load(std::memory_order_acquire) != nullptr || !_pendingFamilies.empty();
+    }
+
+    inline bool hasPendingUpdates(ShadowLane lane, bool includeOffscreen = true) {
+        // call it only within withLock!
+        drainBatches();
+
+        return std::any_of(_pendingFamilies.begin(), _pendingFamilies.end(), [lane, includeOffscreen](auto& pair){
+            return pair.second.lane == lane && (includeOffscreen || !pair.second.placement.isOffscreen);
         });
     }
 
-    inline void removeShadowNode(const ShadowNodeFamily* shadowNodeFamily) {
+    inline size_t countPendingUpdates(ShadowLane lane) {
+        // call it only within withLock!
+        drainBatches();
+
+        return std::count_if(_pendingFamilies.begin(), _pendingFamilies.end(), [lane](auto& pair){
+            return pair.second.lane == lane;
+        });
+    }
+
+    inline std::unordered_map<SurfaceId, PendingSurface> getPendingFamilies(ShadowLane lane) {
         // call it only within withLock!
-        if (_unistylesUpdates.contains(shadowNodeFamily)) {
-            _unistylesUpdates.erase(shadowNodeFamily);
+        std::unordered_map<SurfaceId, PendingSurface> pendingSurfaces{};
+
+        drainBatches();
+
+        for (const auto& [family, pendingLeaf] : _pendingFamilies) {
+            if (pendingLeaf.lane != lane) {
+                continue;
+            }
+
+            auto [pendingSurface, isNew] = pendingSurfaces.try_emplace(pendingLeaf.surfaceId);
+
+            pendingSurface->second.families.emplace(family);
+
+            if (isNew) {
+                pendingSurface->second.placedRevision = pendingLeaf.placement.revision;
+            } else if (pendingSurface->second.placedRevision != pendingLeaf.placement.revision) {
+                pendingSurface->second.placedRevision = std::nullopt;
+            }
+        }
+
+        return pendingSurfaces;
+    }
+
+    inline void setPlacements(ShadowLane lane, const std::unordered_set<SurfaceId>& placedSurfaces, const ShadowLeafPlacements& placements) {
+        // call it only within withLock!
+        // families are placed again whenever shadow tree changes, as they could scroll into view in the meantime
+        // shadow nodes that are not in the shadow tree anymore (or yet) are dropped, React renders them with the latest styles
+        for (auto it = _pendingFamilies.begin(); it != _pendingFamilies.end();) {
+            auto& [family, pendingLeaf] = *it;
+
+            if (pendingLeaf.lane != lane || !placedSurfaces.contains(pendingLeaf.surfaceId)) {
+                it++;
+
+                continue;
+            }
+
+            auto placement = placements.find(family);
+
+            if (placement == placements.end()) {
+                it = _pendingFamilies.erase(it);
+
+                continue;
+            }
+
+            pendingLeaf.placement = placement->second;
+            it++;
+        }
+    }
+
+    inline void addCommitListener(std::function<void()>&& listener) {
+        // call it only within withLock!
+        // listener waits only for updates queued so far, later ones can't delay it
+        drainBatches();
+
+        _commitListeners.emplace_back(ShadowCommitListener{_sequence, std::move(listener)});
+    }
+
+    inline std::vector<std::function<void()>> takeCommitListeners() {
+        // call it only within withLock!
+        // returns listeners whose updates are all committed
+        // off-screen deferred updates wait for idle time, user can't see them, so listeners don't wait for them
+        std::vector<std::function<void()>> commitListeners{};
+        auto oldestSequence = SIZE_MAX;
+
+        drainBatches();
+
+        for (const auto& [family, pendingLeaf] : _pendingFamilies) {
+            if (pendingLeaf.lane == ShadowLane::DEFERRED && pendingLeaf.placement.isOffscreen) {
+                continue;
+            }
+
+            oldestSequence = std::min(oldestSequence, pendingLeaf.sequence);
+        }
+
+        auto listenersEnd = std::stable_partition(_commitListeners.begin(), _commitListeners.end(), [oldestSequence](const ShadowCommitListener& commitListener){
+            return commitListener.sequence >= oldestSequence;
+        });
+
+        for (auto it = listenersEnd; it != _commitListeners.end(); it++) {
+            commitListeners.emplace_back(std::move(it->listener));
+        }
+
+        _commitListeners.erase(listenersEnd, _commitListeners.end());
+
+        return commitListeners;
+    }
+
+    inline bool isCommitting() {
+        // safe to call from any thread
+        // true only on the thread that runs Unistyles commit
+        return _isCommitting;
+    }
+
+    inline void setIsCommitting(bool isCommitting) {
+        _isCommitting = isCommitting;
+    }
+
+    inline bool scheduleFlush() {
+        // returns false if flush is already scheduled, pending updates will be committed by it
+        if (_isFlushScheduled.exchange(true)) {
+            _coalescedFlushes++;
+
+            return false;
         }
+
+        return true;
+    }
+
+    inline void onFlush() {
+        _isFlushScheduled = false;
+    }
+
+    inline bool scheduleIdleFlush() {
+        // returns false if idle flush is already scheduled
+        return !_isIdleFlushScheduled.exchange(true);
+    }
+
+    inline void onIdleFlush() {
+        _isIdleFlushScheduled = false;
+    }
+
+    inline bool isAnyFlushScheduled() {
+        // safe to call from any thread
+        return _isFlushScheduled || _isIdleFlushScheduled;
+    }
+
+    inline void onCommit() {
+        // call it only within withLock!
+        _stats.commits++;
+    }
+
+    inline ShadowTrafficStats getStats() {
+        // call it only within withLock!
+        drainBatches();
+
+        auto stats = _stats;
+
+        stats.coalescedFlushes = _coalescedFlushes.load();
+
+        return stats;
     }
 
     inline void restore() {
         // call it only within withLock!
+        deleteBatches(_batches.exchange(nullptr, std::memory_order_acquire));
 
         _unistylesUpdates = {};
+        _pendingFamilies = {};
+        _inflightFamilies = {};
+        _committedProps = {};
+        _commitListeners = {};
+        _sequence = 0;
+        _isFlushScheduled = false;
+        _isIdleFlushScheduled = false;
         _canCommit = false;
     }
 
@@ -64,8 +414,194 @@ struct ShadowTrafficController {
     }
 
 private:
+    inline std::vector<std::pair<const ShadowNodeFamily*, PendingShadowLeaf>> takePendingFamilies(std::optional<ShadowLane> lane, size_t maxUpdates, bool includeOffscreen) {
+        std::vector<std::pair<const ShadowNodeFamily*, PendingShadowLeaf>> families{};
+        std::vector<std::tuple<SurfaceId, size_t, const ShadowNodeFamily*>> candidates{};
+
+        for (const auto& [family, pendingLeaf] : _pendingFamilies) {
+            if ((lane.has_value() && pendingLeaf.lane != lane.value()) || (!includeOffscreen && pendingLeaf.placement.isOffscreen)) {
+                continue;
+            }
+
+            candidates.emplace_back(pendingLeaf.surfaceId, pendingLeaf.placement.treeOrder, family);
+        }
+
+        // chunk is taken in tree order within single surface, so it clones as few ancestors as possible
+        if (candidates.size() > maxUpdates) {
+            std::partial_sort(candidates.begin(), candidates.begin() + maxUpdates, candidates.end());
+            candidates.resize(maxUpdates);
+        }
+
+        families.reserve(candidates.size());
+
+        for (auto [surfaceId, treeOrder, family] : candidates) {
+            auto pendingLeaf = _pendingFamilies.find(family);
+
+            families.emplace_back(family, pendingLeaf->second);
+            _pendingFamilies.erase(pendingLeaf);
+        }
+
+        return families;
+    }
+
+    inline void pushBatch(ShadowTrafficBatch* batch) {
+        batch->next = _batches.load(std::memory_order_relaxed);
+
+        while (!_batches.compare_exchange_weak(batch->next, batch, std::memory_order_release, std::memory_order_relaxed)) {}
+    }
+
+    inline void drainBatches() {
+        // call it only within withLock!
+        // committer always takes the whole queue, so there is no ABA problem
+        auto batch = _batches.exchange(nullptr, std::memory_order_acquire);
+
+        // queue is LIFO, reverse it to apply batches in the order they were produced
+        ShadowTrafficBatch* orderedBatch = nullptr;
+
+        while (batch != nullptr) {
+            auto next = batch->next;
+
+            batch->next = orderedBatch;
+            orderedBatch = batch;
+            batch = next;
+        }
+
+        while (orderedBatch != nullptr) {
+            auto currentBatch = std::unique_ptr<ShadowTrafficBatch>(orderedBatch);
+
+            orderedBatch = currentBatch->next;
+            _sequence++;
+
+            for (auto& [surfaceId, updates] : currentBatch->updates) {
+                applyUpdates(surfaceId, updates, currentBatch->lane);
+            }
+
+            for (auto [family, surfaceId] : currentBatch->removedFamilies) {
+                applyRemoval(family, surfaceId);
+            }
+        }
+    }
+
+    inline void applyUpdates(SurfaceId surfaceId, shadow::ShadowLeafUpdates& newUpdates, ShadowLane lane) {
+        auto& targetUpdates = this->_unistylesUpdates[surfaceId];
+
+        // this is important as overriding updates may skip some interim changes
+        // Unistyles emits different events so this will make sure that everything is synced
+        std::for_each(newUpdates.begin(), newUpdates.end(), [this, surfaceId, lane, &targetUpdates](auto& pair){
+            this->_stats.receivedUpdates++;
+
+            auto [pendingLeaf, isNew] = this->_pendingFamilies.try_emplace(pair.first, PendingShadowLeaf{surfaceId, lane, this->_sequence});
+
+            // shadow node is still waiting for the commit, so both updates will land in the same one
+            // and if any of them is urgent, the whole update is urgent
+            if (!isNew) {
+                this->_stats.mergedUpdates++;
+
+                if (lane == ShadowLane::URGENT) {
+                    pendingLeaf->second.lane = ShadowLane::URGENT;
+                }
+            }
+
+            auto targetProps = targetUpdates.find(pair.first);
+
+            if (targetProps == targetUpdates.end()) {
+                targetUpdates.emplace(pair.first, std::move(pair.second));
+
+                return;
+            }
+
+            targetProps->second = std::move(pair.second);
+        });
+    }
+
+    inline void applyRemoval(const ShadowNodeFamily* shadowNodeFamily, SurfaceId surfaceId) {
+        auto surfaceUpdates = _unistylesUpdates.find(surfaceId);
+
+        if (surfaceUpdates != _unistylesUpdates.end()) {
+            surfaceUpdates->second.erase(shadowNodeFamily);
+
+            // don't keep empty surfaces, so they won't be committed
+            if (surfaceUpdates->second.empty()) {
+                _unistylesUpdates.erase(surfaceUpdates);
+            }
+        }
+
+        _pendingFamilies.erase(shadowNodeFamily);
+        _inflightFamilies.erase(shadowNodeFamily);
+        forgetCommittedProps(surfaceId, shadowNodeFamily);
+    }
+
+    static inline ShadowTrafficBatch* createBatch(shadow::ShadowLeafUpdates&& newUpdates, ShadowLane lane) {
+        auto batch = new ShadowTrafficBatch{};
+
+        batch->lane = lane;
+
+        for (auto& [family, props] : newUpdates) {
+            batch->updates[family->getSurfaceId()].emplace(family, std::move(props));
+        }
+
+        return batch;
+    }
+
+    static inline void deleteBatches(ShadowTrafficBatch* batch) {
+        while (batch != nullptr) {
+            auto next = batch->next;
+
+            delete batch;
+            batch = next;
+        }
+    }
+
+    // changed keys with new values, removed keys are reset with null
+    static inline folly::dynamic diffProps(const folly::dynamic& committedProps, const folly::dynamic& props) {
+        if (!committedProps.isObject() || !props.isObject()) {
+            return committedProps == props
+                ? folly::dynamic::object()
+                : props;
+        }
+
+        folly::dynamic changedProps = folly::dynamic::object();
+
+        for (const auto& [propName, propValue] : props.items()) {
+            auto committedValue = committedProps.get_ptr(propName);
+
+            if (committedValue == nullptr || *committedValue != propValue) {
+                changedProps[propName] = propValue;
+            }
+        }
+
+        for (const auto& [propName, propValue] : committedProps.items()) {
+            if (props.get_ptr(propName) == nullptr) {
+                changedProps[propName] = nullptr;
+            }
+        }
+
+        return changedProps;
+    }
+
     std::atomic<bool> _canCommit = false;
-    shadow::ShadowLeafUpdates _unistylesUpdates{};
+    std::atomic<bool> _isFlushScheduled = false;
+    std::atomic<bool> _isIdleFlushScheduled = false;
+    // React Native commits synchronously on the calling thread, so commits seen by the commit hook on this thread are ours
+    // commits from other threads (eg. Reanimated on UI thread) are not, even while Unistyles commit is in progress
+    static inline thread_local bool _isCommitting = false;
+    std::atomic<size_t> _coalescedFlushes = 0;
+    // batches pushed by producers, newest first
+    std::atomic<ShadowTrafficBatch*> _batches = nullptr;
+
+    // state below is owned by the committer and guarded by _mutex
+    shadow::SurfaceUpdates _unistylesUpdates{};
+    // shadow nodes updated since the last commit
+    std::unordered_map<const ShadowNodeFamily*, PendingShadowLeaf> _pendingFamilies{};
+    // shadow nodes taken by the committer, waiting for the commit result
+    std::unordered_map<const ShadowNodeFamily*, InflightShadowLeaf> _inflightFamilies{};
+    // props that were committed to the shadow tree for given shadow node
+    // commit hook re-applies them to React commits
+    shadow::SurfaceUpdates _committedProps{};
+    ShadowTrafficStats _stats{};
+    // number of applied batches, orders pending shadow nodes and commit listeners
+    size_t _sequence = 0;
+    std::vector<ShadowCommitListener> _commitListeners{};
 
     // this struct should be accessed in thread-safe manner. Otherwise shadow tree updates
     // from different threads will break it
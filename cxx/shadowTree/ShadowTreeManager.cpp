@@ -7,65 +7,444 @@ using namespace facebook;
 using AffectedNodes = std::unordered_map<const ShadowNodeFamily*, std::unordered_set<int>>;
 
 void shadow::ShadowTreeManager::updateShadowTree(jsi::Runtime& rt) {
+    // immediate flush, commits all lanes at once
+    auto surfaceUpdates = shadow::ShadowTreeManager::takeShadowLeafUpdates(std::nullopt, SIZE_MAX);
+
+    shadow::ShadowTreeManager::commitShadowLeafUpdates(rt, surfaceUpdates);
+    shadow::ShadowTreeManager::notifyCommitListeners();
+}
+
+void shadow::ShadowTreeManager::flushScheduledUpdates(jsi::Runtime& rt) {
     auto& registry = core::UnistylesRegistry::get();
+    auto startTime = std::chrono::steady_clock::now();
+    auto hasVisibleUpdates = false;
+
+    registry.trafficController.onFlush();
+
+    if (shadow::ShadowTreeManager::shouldChunkUrgentUpdates()) {
+        shadow::ShadowTreeManager::placePendingUpdates(rt, ShadowLane::URGENT);
+
+        // visible first, but urgent off-screen updates don't wait for idle time
+        hasVisibleUpdates = shadow::ShadowTreeManager::commitChunkedUpdates(rt, ShadowLane::URGENT, startTime, false) ||
+            shadow::ShadowTreeManager::commitChunkedUpdates(rt, ShadowLane::URGENT, startTime, true);
 
-    registry.trafficController.withLock([&](){
-        auto updates = registry.trafficController.getUpdates();
+        shadow::ShadowTreeManager::placePendingUpdates(rt, ShadowLane::DEFERRED);
 
-        if (updates.empty()) {
-            return;
+        auto visibleUpdates = shadow::ShadowTreeManager::takeShadowLeafUpdates(ShadowLane::DEFERRED, SIZE_MAX, false);
+
+        shadow::ShadowTreeManager::commitShadowLeafUpdates(rt, visibleUpdates);
+    } else {
+        shadow::ShadowTreeManager::placePendingUpdates(rt, ShadowLane::DEFERRED);
+
+        // urgent and visible deferred updates land in single transaction
+        // so eg. theme change is never shown half applied, off-screen shadow nodes are not committed here
+        auto visibleUpdates = shadow::ShadowTreeManager::takeShadowLeafUpdates(ShadowLane::URGENT, SIZE_MAX);
+        auto deferredUpdates = shadow::ShadowTreeManager::takeShadowLeafUpdates(ShadowLane::DEFERRED, SIZE_MAX, false);
+
+        for (auto& [surfaceId, updates] : deferredUpdates) {
+            visibleUpdates[surfaceId].merge(updates);
         }
 
-#if REACT_NATIVE_VERSION_MINOR >= 81
-        std::unordered_map<Tag, folly::dynamic> tagToProps;
+        shadow::ShadowTreeManager::commitShadowLeafUpdates(rt, visibleUpdates);
+    }
 
-        for (const auto& [family, props] : updates) {
-            tagToProps.insert({family->getTag(), props});
+    auto hasOffscreenUpdates = registry.trafficController.withLock([&registry](){
+        return registry.trafficController.hasPendingUpdates(ShadowLane::DEFERRED);
+    });
+
+    // rest of urgent updates will be committed in the next frames
+    if (hasVisibleUpdates) {
+        shadow::ShadowTreeManager::scheduleShadowTreeUpdate(rt);
+    } else if (hasOffscreenUpdates) {
+        shadow::ShadowTreeManager::scheduleIdleShadowTreeUpdate(rt);
+    }
+
+    shadow::ShadowTreeManager::notifyCommitListeners();
+}
+
+void shadow::ShadowTreeManager::flushIdleUpdates(jsi::Runtime& rt) {
+    auto& registry = core::UnistylesRegistry::get();
+    auto startTime = std::chrono::steady_clock::now();
+
+    registry.trafficController.onIdleFlush();
+
+    // some of the shadow nodes could scroll into view in the meantime, so they go first and at once
+    shadow::ShadowTreeManager::placePendingUpdates(rt, ShadowLane::DEFERRED);
 
-            // Store in native props system to preserve during Reanimated cloning
-            const_cast<ShadowNodeFamily*>(family)->nativeProps_DEPRECATED =
-                std::make_unique<folly::dynamic>(props);
+    auto visibleUpdates = shadow::ShadowTreeManager::takeShadowLeafUpdates(ShadowLane::DEFERRED, SIZE_MAX, false);
+
+    shadow::ShadowTreeManager::commitShadowLeafUpdates(rt, visibleUpdates);
+
+    // only off-screen shadow nodes are time sliced
+    if (shadow::ShadowTreeManager::commitChunkedUpdates(rt, ShadowLane::DEFERRED, startTime, true)) {
+        shadow::ShadowTreeManager::scheduleIdleShadowTreeUpdate(rt);
+    }
+
+    shadow::ShadowTreeManager::notifyCommitListeners();
+}
+
+bool shadow::ShadowTreeManager::shouldChunkUrgentUpdates() {
+    auto& registry = core::UnistylesRegistry::get();
+
+    // chunked mode is opt-in, as it spreads single change across multiple frames
+    if (registry.commitBudget == 0) {
+        return false;
+    }
+
+    return registry.trafficController.withLock([&registry](){
+        return registry.trafficController.countPendingUpdates(ShadowLane::URGENT) >= CHUNKED_COMMIT_THRESHOLD;
+    });
+}
+
+bool shadow::ShadowTreeManager::commitChunkedUpdates(jsi::Runtime& rt, ShadowLane lane, std::chrono::steady_clock::time_point startTime, bool includeOffscreen) {
+    auto& registry = core::UnistylesRegistry::get();
+    auto commitBudget = std::chrono::duration<double, std::milli>(registry.commitBudget > 0
+        ? registry.commitBudget
+        : DEFAULT_COMMIT_BUDGET
+    );
+    auto hasChunkedUpdates = [&registry, lane, includeOffscreen](){
+        return registry.trafficController.withLock([&registry, lane, includeOffscreen](){
+            return registry.trafficController.hasPendingUpdates(lane, includeOffscreen);
+        });
+    };
+
+    // updates are committed in chunks, until frame budget is used
+    while (std::chrono::steady_clock::now() - startTime < commitBudget) {
+        if (!hasChunkedUpdates()) {
+            return false;
         }
 
+        auto chunkedUpdates = shadow::ShadowTreeManager::takeShadowLeafUpdates(lane, COMMIT_CHUNK_SIZE, includeOffscreen);
+
+        // not committed shadow nodes are pending again, once only they are left this loop would spin until budget is used
+        if (!shadow::ShadowTreeManager::commitShadowLeafUpdates(rt, chunkedUpdates)) {
+            return false;
+        }
+    }
+
+    return hasChunkedUpdates();
+}
+
+void shadow::ShadowTreeManager::placePendingUpdates(jsi::Runtime& rt, ShadowLane lane) {
+    auto& registry = core::UnistylesRegistry::get();
+    auto pendingSurfaces = registry.trafficController.withLock([&registry, lane](){
+        return registry.trafficController.getPendingFamilies(lane);
+    });
+
+    if (pendingSurfaces.empty()) {
+        return;
+    }
+
+    const auto& shadowTreeRegistry = UIManagerBinding::getBinding(rt)->getUIManager().getShadowTreeRegistry();
+    std::unordered_set<SurfaceId> placedSurfaces;
+    ShadowLeafPlacements placements;
+
+    for (const auto& [surfaceId, pendingSurface] : pendingSurfaces) {
+        auto hasSurface = shadowTreeRegistry.visit(surfaceId, [surfaceId, &pendingSurface, &placedSurfaces, &placements](const ShadowTree& shadowTree){
+            auto revision = shadowTree.getCurrentRevision();
+
+            // nothing was committed since pending shadow nodes were placed, so they're still in the same place
+            if (pendingSurface.placedRevision == revision.number) {
+                return;
+            }
+
+            shadow::ShadowTreeManager::findPlacements(*revision.rootShadowNode, revision.number, pendingSurface.families, placements);
+            placedSurfaces.insert(surfaceId);
+        });
+
+        // surface was stopped, its shadow nodes are gone
+        if (!hasSurface) {
+            placedSurfaces.insert(surfaceId);
+        }
+    }
+
+    if (placedSurfaces.empty()) {
+        return;
+    }
+
+    registry.trafficController.withLock([&registry, lane, &placedSurfaces, &placements](){
+        registry.trafficController.setPlacements(lane, placedSurfaces, placements);
+    });
+}
+
+// single traversal with absolute frames computed from the latest committed layout
+// shadow nodes without layout (eg. not laid out yet) are considered visible
+// it stops once all families are found, shadow nodes that are not in the tree get no placement
+void shadow::ShadowTreeManager::findPlacements(const RootShadowNode& rootNode, ShadowTreeRevision::Number revision, const std::unordered_set<const ShadowNodeFamily*>& families, ShadowLeafPlacements& placements) {
+    auto viewport = rootNode.getLayoutMetrics().frame;
+
+    // shadow nodes close to the viewport are treated as visible, so they're ready before they scroll into view
+    viewport.origin.x -= viewport.size.width * OFFSCREEN_VIEWPORT_MARGIN;
+    viewport.origin.y -= viewport.size.height * OFFSCREEN_VIEWPORT_MARGIN;
+    viewport.size.width += 2 * viewport.size.width * OFFSCREEN_VIEWPORT_MARGIN;
+    viewport.size.height += 2 * viewport.size.height * OFFSCREEN_VIEWPORT_MARGIN;
+
+    auto remainingFamilies = families.size();
+    size_t treeOrder = 0;
+    std::vector<std::pair<const ShadowNode*, Point>> stack{{&rootNode, Point{0, 0}}};
+
+    while (!stack.empty() && remainingFamilies > 0) {
+        auto [shadowNode, parentOrigin] = stack.back();
+        auto childrenOrigin = parentOrigin;
+
+        stack.pop_back();
+
+        // every subtree gets continuous range of indexes
+        auto placement = ShadowLeafPlacement{false, treeOrder++, revision};
+        auto isPending = families.contains(&shadowNode->getFamily());
+        // trait check is much cheaper than dynamic_cast for every shadow node
+        auto layoutableShadowNode = shadowNode->getTraits().check(ShadowNodeTraits::Trait::LayoutableKind)
+            ? static_cast<const LayoutableShadowNode*>(shadowNode)
+            : nullptr;
+
+        if (layoutableShadowNode != nullptr) {
+            auto layoutMetrics = layoutableShadowNode->getLayoutMetrics();
+            auto frame = layoutMetrics.frame;
+
+            frame.origin.x += parentOrigin.x;
+            frame.origin.y += parentOrigin.y;
+
+            placement.isOffscreen = layoutMetrics != EmptyLayoutMetrics && !(
+                frame.origin.x < viewport.origin.x + viewport.size.width &&
+                frame.origin.x + frame.size.width > viewport.origin.x &&
+                frame.origin.y < viewport.origin.y + viewport.size.height &&
+                frame.origin.y + frame.size.height > viewport.origin.y
+            );
+
+            // eg. ScrollView shifts its children by content offset
+            auto contentOriginOffset = layoutableShadowNode->getContentOriginOffset(false);
+
+            childrenOrigin = Point{frame.origin.x + contentOriginOffset.x, frame.origin.y + contentOriginOffset.y};
+        }
+
+        if (isPending) {
+            remainingFamilies--;
+            placements.emplace(&shadowNode->getFamily(), placement);
+        }
+
+        for (const auto& child : shadowNode->getChildren()) {
+            stack.emplace_back(child.get(), childrenOrigin);
+        }
+    }
+}
+
+void shadow::ShadowTreeManager::notifyCommitListeners() {
+    auto& registry = core::UnistylesRegistry::get();
+
+    // listeners are called only after their updates landed
+    auto commitListeners = registry.trafficController.withLock([&registry](){
+        return registry.trafficController.takeCommitListeners();
+    });
+
+    for (auto& listener : commitListeners) {
+        listener();
+    }
+}
+
+shadow::SurfaceUpdates shadow::ShadowTreeManager::takeShadowLeafUpdates(std::optional<ShadowLane> lane, size_t maxUpdates, bool includeOffscreen) {
+    auto& registry = core::UnistylesRegistry::get();
+
+    // lock is held only to collect updates, so producers and React commits don't wait for our commit
+    // only changed props are committed, shadow nodes with the same props are skipped
+    return registry.trafficController.withLock([&registry, lane, maxUpdates, includeOffscreen](){
+        return registry.trafficController.takeUncommittedUpdates(lane, maxUpdates, includeOffscreen);
+    });
+}
+
+bool shadow::ShadowTreeManager::commitShadowLeafUpdates(jsi::Runtime& rt, SurfaceUpdates& surfaceUpdates) {
+    if (surfaceUpdates.empty()) {
+        return true;
+    }
+
+    auto& registry = core::UnistylesRegistry::get();
+    // props are recorded as committed only for these shadow nodes
+    CommittedFamilies committedFamilies;
+
+    // commit hook skips our own commits
+    registry.trafficController.setIsCommitting(true);
+
+#if REACT_NATIVE_VERSION_MINOR >= 81
+    std::unordered_map<Tag, folly::dynamic> tagToProps;
+
+    // React Native resolves surfaces for given tags on its own, and silently skips unknown ones
+    // they are recorded as committed anyway, without walking the shadow tree
+    // shadow node that enters the tree later gets its committed props from the commit hook
+    // and unlinked shadow nodes are forgotten in removeShadowNode
+    for (auto& [surfaceId, updates] : surfaceUpdates) {
+        auto& surfaceCommittedFamilies = committedFamilies[surfaceId];
+
+        for (auto& [family, props] : updates) {
+            surfaceCommittedFamilies.insert(family);
+            tagToProps.insert({family->getTag(), std::move(props)});
+        }
+    }
+
+    if (!tagToProps.empty()) {
         UIManagerBinding::getBinding(rt)->getUIManager().updateShadowTree(std::move(tagToProps));
+    }
 #else
-        const auto& shadowTreeRegistry = UIManagerBinding::getBinding(rt)->getUIManager().getShadowTreeRegistry();
+    const auto& shadowTreeRegistry = UIManagerBinding::getBinding(rt)->getUIManager().getShadowTreeRegistry();
+
+    // visit only surfaces with updates, other shadow trees are not traversed at all
+    for (auto& [surfaceId, updates] : surfaceUpdates) {
+        auto& surfaceCommittedFamilies = committedFamilies[surfaceId];
+
+        shadowTreeRegistry.visit(surfaceId, [&updates, &surfaceCommittedFamilies](const ShadowTree& shadowTree){
+            std::unordered_set<const ShadowNodeFamily*> foundFamilies;
 
-        shadowTreeRegistry.enumerate([&updates](const ShadowTree& shadowTree, bool& stop){
             // we could iterate via updates and create multiple commits
             // but it can cause performance issues for hundreds of nodes
             // so let's mutate Shadow Tree in single transaction
-            auto transaction = [&updates](const RootShadowNode& oldRootShadowNode) {
-                auto affectedNodes = shadow::ShadowTreeManager::findAffectedNodes(oldRootShadowNode, updates);
-
-                for (const auto& [family, props] : updates) {
-                    // Merge props to fix glitches caused by REA updates
-                    const_cast<ShadowNodeFamily*>(family)->nativeProps_DEPRECATED =
-                        std::make_unique<folly::dynamic>(props);
-                }
+            auto transaction = [&updates, &foundFamilies](const RootShadowNode& oldRootShadowNode) {
+                // transaction is called again if other commit landed in the meantime
+                foundFamilies.clear();
 
-                return  std::static_pointer_cast<RootShadowNode>(shadow::ShadowTreeManager::cloneShadowTree(
+                auto affectedNodes = shadow::ShadowTreeManager::findAffectedNodes(oldRootShadowNode, updates, &foundFamilies);
+                auto newRootShadowNode = std::static_pointer_cast<RootShadowNode>(shadow::ShadowTreeManager::cloneShadowTree(
                     oldRootShadowNode,
                     updates,
                     affectedNodes
                 ));
+
+                // mark this commit as Unistyles commit, so commit hook will skip it
+                std::reinterpret_pointer_cast<core::UnistylesCommitShadowNode>(newRootShadowNode)->addUnistylesCommitTrait();
+
+                return newRootShadowNode;
             };
 
-            // commit once!
+            // commit once per surface!
             // CommitOptions:
             // enableStateReconciliation: https://reactnative.dev/architecture/render-pipeline#react-native-renderer-state-updates
             // mountSynchronously: must be true as this is update from C++ not React
-            shadowTree.commit(transaction, {false, true});
-
-            // for now we're assuming single surface, can be improved in the future
-            // stop = true means stop enumerating next shadow tree
-            // so in other words first shadow tree is our desired tree
-            stop = true;
+            if (shadowTree.commit(transaction, {false, true}) == ShadowTree::CommitStatus::Succeeded) {
+                surfaceCommittedFamilies = std::move(foundFamilies);
+            }
         });
+    }
+#endif
+
+    registry.trafficController.setIsCommitting(false);
+
+    return registry.trafficController.withLock([&registry, &committedFamilies](){
+        registry.trafficController.onCommit();
+
+        auto committedUpdates = registry.trafficController.settleInflightUpdates(committedFamilies);
+
+#if REACT_NATIVE_VERSION_MINOR < 80
+        // commit hook can't re-apply props on these versions
+        // store them in native props system to preserve during React and Reanimated cloning
+        for (const auto& [surfaceId, families] : committedFamilies) {
+            auto surfaceCommittedUpdates = registry.trafficController.getCommittedUpdates(surfaceId);
+
+            if (surfaceCommittedUpdates == nullptr) {
+                continue;
+            }
+
+            for (auto family : families) {
+                auto committedProps = surfaceCommittedUpdates->find(family);
+
+                // committed update may contain only changed keys, so native props need the full ones
+                if (committedProps != surfaceCommittedUpdates->end()) {
+                    const_cast<ShadowNodeFamily*>(family)->nativeProps_DEPRECATED = std::make_unique<folly::dynamic>(committedProps->second);
+                }
+            }
+        }
 #endif
+
+        // false only if none of the shadow nodes could be committed
+        return committedUpdates > 0;
     });
 }
 
+void shadow::ShadowTreeManager::scheduleShadowTreeUpdate(jsi::Runtime& rt) {
+    auto& registry = core::UnistylesRegistry::get();
+
+    // flush is already scheduled, updates will be merged into it
+    if (!registry.trafficController.scheduleFlush()) {
+        return;
+    }
+
+    shadow::ShadowTreeManager::requestFlush(rt);
+}
+
+// call it only after trafficController.scheduleFlush returned true
+void shadow::ShadowTreeManager::requestFlush(jsi::Runtime& rt) {
+    auto& registry = core::UnistylesRegistry::get();
+
+    // by default commit once per frame, otherwise use user's interval
+    auto wasScheduled = registry.commitInterval > 0
+        ? shadow::ShadowTreeManager::callScheduler(rt, "setTimeout", &shadow::ShadowTreeManager::flushScheduledUpdates, registry.commitInterval)
+        : shadow::ShadowTreeManager::callScheduler(rt, "requestAnimationFrame", &shadow::ShadowTreeManager::flushScheduledUpdates, std::nullopt);
+
+    if (!wasScheduled) {
+        registry.trafficController.onFlush();
+        shadow::ShadowTreeManager::updateShadowTree(rt);
+    }
+}
+
+void shadow::ShadowTreeManager::scheduleShadowTreeUpdate(jsi::Runtime& rt, std::function<void()>&& onCommitted) {
+    auto& registry = core::UnistylesRegistry::get();
+
+    registry.trafficController.withLock([&registry, &onCommitted](){
+        registry.trafficController.addCommitListener(std::move(onCommitted));
+    });
+
+    shadow::ShadowTreeManager::scheduleShadowTreeUpdate(rt);
+}
+
+void shadow::ShadowTreeManager::scheduleIdleShadowTreeUpdate(jsi::Runtime& rt) {
+    auto& registry = core::UnistylesRegistry::get();
+
+    if (!registry.trafficController.scheduleIdleFlush()) {
+        return;
+    }
+
+    shadow::ShadowTreeManager::requestIdleFlush(rt);
+}
+
+// call it only after trafficController.scheduleIdleFlush returned true
+void shadow::ShadowTreeManager::requestIdleFlush(jsi::Runtime& rt) {
+    auto& registry = core::UnistylesRegistry::get();
+
+    // not every JS engine has idle callback, fallback to next frames
+    auto wasScheduled = shadow::ShadowTreeManager::callScheduler(rt, "requestIdleCallback", &shadow::ShadowTreeManager::flushIdleUpdates, std::nullopt) ||
+        shadow::ShadowTreeManager::callScheduler(rt, "setTimeout", &shadow::ShadowTreeManager::flushIdleUpdates, IDLE_FLUSH_FALLBACK_DELAY);
+
+    if (!wasScheduled) {
+        registry.trafficController.onIdleFlush();
+        shadow::ShadowTreeManager::updateShadowTree(rt);
+    }
+}
+
+bool shadow::ShadowTreeManager::callScheduler(jsi::Runtime& rt, const char* schedulerName, void (*callback)(jsi::Runtime&), std::optional<double> delay) {
+    auto scheduler = rt.global().getProperty(rt, schedulerName);
+
+    if (!scheduler.isObject() || !scheduler.asObject(rt).isFunction(rt)) {
+        return false;
+    }
+
+    auto flush = jsi::Function::createFromHostFunction(
+        rt,
+        jsi::PropNameID::forAscii(rt, "flushUnistylesUpdates"),
+        0,
+        [callback](jsi::Runtime& rt, const jsi::Value& thisValue, const jsi::Value* args, size_t count){
+            callback(rt);
+
+            return jsi::Value::undefined();
+        }
+    );
+
+    if (delay.has_value()) {
+        scheduler.asObject(rt).asFunction(rt).call(rt, std::move(flush), jsi::Value(delay.value()));
+
+        return true;
+    }
+
+    scheduler.asObject(rt).asFunction(rt).call(rt, std::move(flush));
+
+    return true;
+}
+
 // based on Reanimated algorithm
 // For each affected family we're gathering affected nodes (their indexes)
 // Example:
@@ -83,24 +462,101 @@ void shadow::ShadowTreeManager::updateShadowTree(jsi::Runtime& rt) {
 //  1 - because E is a second children of B
 //]
 // A, B and E are affected now
-AffectedNodes shadow::ShadowTreeManager::findAffectedNodes(const RootShadowNode& rootNode, ShadowLeafUpdates& updates) {
+// shadow nodes that are not in the tree are not affected, optionally found ones are collected
+AffectedNodes shadow::ShadowTreeManager::findAffectedNodes(const RootShadowNode& rootNode, ShadowLeafUpdates& updates, std::unordered_set<const ShadowNodeFamily*>* foundFamilies) {
+    // for bigger batches single traversal is cheaper than walking from the root for every family
+    if (updates.size() >= BATCHED_ANCESTORS_THRESHOLD) {
+        return findAffectedNodesInSingleTraversal(rootNode, updates, foundFamilies);
+    }
+
     AffectedNodes affectedNodes;
+    AncestorsPath path;
 
     for (const auto& [family, _] : updates) {
         auto familyAncestors = family->getAncestors(rootNode);
 
-        for (auto it = familyAncestors.rbegin(); it != familyAncestors.rend(); ++it) {
-            const auto& [parentNode, index] = *it;
-            const auto parentFamily = &parentNode.get().getFamily();
-            auto [setIt, inserted] = affectedNodes.try_emplace(parentFamily, std::unordered_set<int>{});
+        // empty for shadow nodes from other surfaces or not mounted yet
+        if (familyAncestors.empty()) {
+            continue;
+        }
+
+        if (foundFamilies != nullptr) {
+            foundFamilies->insert(family);
+        }
+
+        path.clear();
+
+        for (const auto& [parentNode, index] : familyAncestors) {
+            path.emplace_back(&parentNode.get().getFamily(), index);
+        }
+
+        markAffectedPath(affectedNodes, path);
+    }
+
+    return affectedNodes;
+}
+
+// iterative DFS that tracks the current path and stops once every updated family was found
+AffectedNodes shadow::ShadowTreeManager::findAffectedNodesInSingleTraversal(const RootShadowNode& rootNode, ShadowLeafUpdates& updates, std::unordered_set<const ShadowNodeFamily*>* foundFamilies) {
+    AffectedNodes affectedNodes;
+    AncestorsPath path;
+    std::vector<std::pair<const ShadowNode*, size_t>> stack{{&rootNode, 0}};
+    auto surfaceId = rootNode.getSurfaceId();
+    // shadow nodes from other surfaces are never found, counting them would walk the whole tree
+    auto remainingFamilies = static_cast<size_t>(std::count_if(updates.begin(), updates.end(), [surfaceId](const auto& pair){
+        return pair.first->getSurfaceId() == surfaceId;
+    }));
+
+    if (updates.contains(&rootNode.getFamily())) {
+        remainingFamilies--;
+    }
+
+    while (!stack.empty() && remainingFamilies > 0) {
+        auto [node, childIndex] = stack.back();
+        const auto& children = node->getChildren();
 
-            setIt->second.insert(index);
+        if (childIndex >= children.size()) {
+            stack.pop_back();
+
+            if (!path.empty()) {
+                path.pop_back();
+            }
+
+            continue;
+        }
+
+        stack.back().second++;
+
+        const auto& child = children[childIndex];
+
+        path.emplace_back(&node->getFamily(), static_cast<int>(childIndex));
+        stack.emplace_back(child.get(), 0);
+
+        if (updates.contains(&child->getFamily())) {
+            markAffectedPath(affectedNodes, path);
+            remainingFamilies--;
+
+            if (foundFamilies != nullptr) {
+                foundFamilies->insert(&child->getFamily());
+            }
         }
     }
 
     return affectedNodes;
 }
 
+// walks from the closest parent up, once we hit already marked edge the rest of the path is shared
+void shadow::ShadowTreeManager::markAffectedPath(AffectedNodes& affectedNodes, const AncestorsPath& path) {
+    for (auto it = path.rbegin(); it != path.rend(); ++it) {
+        const auto& [parentFamily, index] = *it;
+        auto [_, inserted] = affectedNodes[parentFamily].insert(index);
+
+        if (!inserted) {
+            break;
+        }
+    }
+}
+
 Props::Shared shadow::ShadowTreeManager::computeUpdatedProps(const ShadowNode &shadowNode, ShadowLeafUpdates& updates) {
     const auto family = &shadowNode.getFamily();
     const auto rawPropsIt = updates.find(family);
@@ -135,19 +591,17 @@ std::shared_ptr<ShadowNode> shadow::ShadowTreeManager::cloneShadowTree(const Sha
     const auto childrenIt = affectedNodes.find(family);
 
     // Only copy children if we need to update them
-    std::shared_ptr<std::vector<std::shared_ptr<const ShadowNode>>> childrenPtr;
-    const auto& originalChildren = shadowNode.getChildren();
+    // placeholder tells React Native to reuse children of the source node
+    std::shared_ptr<const std::vector<std::shared_ptr<const ShadowNode>>> childrenPtr = ShadowNodeFragment::childrenPlaceholder();
 
     if (childrenIt != affectedNodes.end()) {
-        auto children = originalChildren;
+        auto children = shadowNode.getChildren();
 
         for (const auto index : childrenIt->second) {
             children[index] = cloneShadowTree(*children[index], updates, affectedNodes);
         }
 
-        childrenPtr = std::make_shared<std::vector<std::shared_ptr<const ShadowNode>>>(std::move(children));
-    } else {
-        childrenPtr = std::make_shared<std::vector<std::shared_ptr<const ShadowNode>>>(originalChildren);
+        childrenPtr = std::make_shared<const std::vector<std::shared_ptr<const ShadowNode>>>(std::move(children));
     }
 
     Props::Shared updatedProps = computeUpdatedProps(shadowNode, updates);
@@ -3,9 +3,14 @@
 #include <jsi/jsi.h>
 #include <react/renderer/uimanager/UIManagerBinding.h>
 #include <react/renderer/uimanager/UIManager.h>
+#include <react/renderer/core/LayoutableShadowNode.h>
+#include <chrono>
+#include <functional>
+#include <optional>
 #include <ranges>
 #include "ShadowLeafUpdate.h"
 #include "UnistylesRegistry.h"
+#include "UnistylesCommitShadowNode.h"
 #include <cxxreact/ReactNativeVersion.h>
 
 namespace margelo::nitro::unistyles::shadow {
@@ -14,10 +19,43 @@ using namespace facebook::react;
 using namespace facebook;
 
 using AffectedNodes = std::unordered_map<const ShadowNodeFamily *, std::unordered_set<int>>;
+using AncestorsPath = std::vector<std::pair<const ShadowNodeFamily *, int>>;
+
+// number of updates from which single tree traversal is used instead of per family ancestors lookup
+// heuristic: lookup walks up from every updated node, traversal visits the whole tree once
+// so traversal pays off only for large update sets, 256 wasn't measured on real apps
+constexpr size_t BATCHED_ANCESTORS_THRESHOLD = 256;
+// chunked updates are committed in chunks of this size, as long as frame budget allows
+constexpr size_t COMMIT_CHUNK_SIZE = 32;
+// used for off-screen deferred updates, unless user set commitBudget
+constexpr double DEFAULT_COMMIT_BUDGET = 4;
+// with commitBudget, urgent updates are chunked too, but only from this size
+constexpr size_t CHUNKED_COMMIT_THRESHOLD = 256;
+// fraction of the viewport around it, where shadow nodes are still considered visible
+constexpr float OFFSCREEN_VIEWPORT_MARGIN = 0.5;
+// used when JS engine doesn't support requestIdleCallback
+constexpr double IDLE_FLUSH_FALLBACK_DELAY = 100;
 
 struct ShadowTreeManager {
     static void updateShadowTree(jsi::Runtime& rt);
-    static AffectedNodes findAffectedNodes(const RootShadowNode& rootNode, ShadowLeafUpdates& updates);
+    static void scheduleShadowTreeUpdate(jsi::Runtime& rt);
+    static void scheduleShadowTreeUpdate(jsi::Runtime& rt, std::function<void()>&& onCommitted);
+    static void requestFlush(jsi::Runtime& rt);
+    static void scheduleIdleShadowTreeUpdate(jsi::Runtime& rt);
+    static void requestIdleFlush(jsi::Runtime& rt);
+    static bool callScheduler(jsi::Runtime& rt, const char* schedulerName, void (*callback)(jsi::Runtime&), std::optional<double> delay);
+    static void flushScheduledUpdates(jsi::Runtime& rt);
+    static void flushIdleUpdates(jsi::Runtime& rt);
+    static bool shouldChunkUrgentUpdates();
+    static bool commitChunkedUpdates(jsi::Runtime& rt, ShadowLane lane, std::chrono::steady_clock::time_point startTime, bool includeOffscreen);
+    static void placePendingUpdates(jsi::Runtime& rt, ShadowLane lane);
+    static void findPlacements(const RootShadowNode& rootNode, ShadowTreeRevision::Number revision, const std::unordered_set<const ShadowNodeFamily*>& families, ShadowLeafPlacements& placements);
+    static void notifyCommitListeners();
+    static SurfaceUpdates takeShadowLeafUpdates(std::optional<ShadowLane> lane, size_t maxUpdates, bool includeOffscreen = true);
+    static bool commitShadowLeafUpdates(jsi::Runtime& rt, SurfaceUpdates& surfaceUpdates);
+    static AffectedNodes findAffectedNodes(const RootShadowNode& rootNode, ShadowLeafUpdates& updates, std::unordered_set<const ShadowNodeFamily*>* foundFamilies = nullptr);
+    static AffectedNodes findAffectedNodesInSingleTraversal(const RootShadowNode& rootNode, ShadowLeafUpdates& updates, std::unordered_set<const ShadowNodeFamily*>* foundFamilies);
+    static void markAffectedPath(AffectedNodes& affectedNodes, const AncestorsPath& path);
     static std::shared_ptr<ShadowNode> cloneShadowTree(const ShadowNode& shadowNode, ShadowLeafUpdates& updates, AffectedNodes& affectedNodes);
     static Props::Shared computeUpdatedProps(const ShadowNode &shadowNode, ShadowLeafUpdates& updates);
 };
@@ -201,9 +201,14 @@ jest.mock('react-native-unistyles', () => {
                     _REGISTRY.themes = config.themes
                 }
             },
+            release: () => {},
+            getRegistryStats: () => ({
+                styleSheets: 0,
+                unistyles: 0,
+                evictedStyleSheets: 0
+            }),
             jsMethods: {
-                processColor: () => null,
-                parseBoxShadowString: () => []
+                processColor: () => null
             },
             hairlineWidth: 1,
             unid: -1,
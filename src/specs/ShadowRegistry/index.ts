@@ -1,6 +1,6 @@
 import { NitroModules } from 'react-native-nitro-modules'
 import type { UnistylesShadowRegistry as UnistylesShadowRegistrySpec } from './ShadowRegistry.nitro'
-import type { ShadowNode, Unistyle, ViewHandle } from './types'
+import type { ShadowCommitStats, ShadowNode, Unistyle, ViewHandle } from './types'
 
 interface ShadowRegistry extends UnistylesShadowRegistrySpec {
     // Babel API
@@ -10,6 +10,7 @@ interface ShadowRegistry extends UnistylesShadowRegistrySpec {
     link(node: ShadowNode, styles?: Array<Unistyle>): void,
     unlink(node: ShadowNode): void,
     flush(): void,
+    getCommitStats(): ShadowCommitStats,
     setScopedTheme(themeName?: string): void,
     getScopedTheme(): string | undefined
 }
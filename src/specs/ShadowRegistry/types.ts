@@ -48,3 +48,11 @@ export type Unistyle = {
         updater?: () => void
     }
 }
+
+export type ShadowCommitStats = {
+    receivedUpdates: number,
+    mergedUpdates: number,
+    coalescedFlushes: number,
+    unchangedUpdates: number,
+    commits: number
+}
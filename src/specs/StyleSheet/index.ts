@@ -1,7 +1,6 @@
 import { StyleSheet as NativeStyleSheet, processColor } from 'react-native'
 import type { StyleSheet as NativeStyleSheetType } from 'react-native'
 import { NitroModules } from 'react-native-nitro-modules'
-import { parseBoxShadowString } from '../../core/parseBoxShadow'
 import type { UnistylesBreakpoints, UnistylesThemes } from '../../global'
 import type { CreateUnistylesStyleSheet } from '../../types'
 import type { UnistylesStyleSheet as UnistylesStyleSheetSpec } from './UnistylesStyleSheet.nitro'
@@ -19,7 +18,15 @@ type UnistylesThemeSettings = {
 
 type UnistylesSettings = UnistylesThemeSettings & {
     CSSVars?: boolean,
-    nativeBreakpointsMode?: 'pixels' | 'points'
+    nativeBreakpointsMode?: 'pixels' | 'points',
+    commitInterval?: number,
+    commitBudget?: number
+}
+
+export type StyleSheetRegistryStats = {
+    styleSheets: number,
+    unistyles: number,
+    evictedStyleSheets: number
 }
 
 export type UnistylesConfig = {
@@ -38,9 +45,10 @@ export interface UnistylesStyleSheet extends UnistylesStyleSheetSpec {
     init(): void,
     create: CreateUnistylesStyleSheet,
     configure(config: UnistylesConfig): void,
+    release(styles: object): void,
+    getRegistryStats(): StyleSheetRegistryStats,
     jsMethods: {
-        processColor: typeof processColor,
-        parseBoxShadowString: typeof parseBoxShadowString
+        processColor: typeof processColor
     }
 }
 
@@ -52,8 +60,7 @@ HybridUnistylesStyleSheet.absoluteFill = NativeStyleSheet.absoluteFill
 HybridUnistylesStyleSheet.flatten = NativeStyleSheet.flatten
 HybridUnistylesStyleSheet.compose = NativeStyleSheet.compose
 HybridUnistylesStyleSheet.jsMethods = {
-    processColor,
-    parseBoxShadowString
+    processColor
 }
 
 HybridUnistylesStyleSheet.init()
@@ -24,7 +24,13 @@ export const StyleSheet = {
     },
     compose: (a: object, b: object) => RNStyleSheet.compose(a, b),
     flatten: (...styles: Array<object>) => RNStyleSheet.flatten(...styles),
-    hairlineWidth: 1
+    hairlineWidth: 1,
+    release: () => {},
+    getRegistryStats: () => ({
+        styleSheets: 0,
+        unistyles: 0,
+        evictedStyleSheets: 0
+    })
 } as unknown as typeof NativeStyleSheet
 
 export const UnistylesRuntime = unistyles.services.runtime as unknown as typeof NativeUnistylesRuntime
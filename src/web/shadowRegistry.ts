@@ -120,4 +120,12 @@ export class UnistylesShadowRegistry {
     }
 
     flush = () => {}
+
+    getCommitStats = () => ({
+        receivedUpdates: 0,
+        mergedUpdates: 0,
+        coalescedFlushes: 0,
+        unchangedUpdates: 0,
+        commits: 0
+    })
 }